@@ -1,15 +1,54 @@
 #pragma once
 
+#include <array>
 #include <ostream>
 #include <memory>
+#include <string>
 #include <vector>
 
 using byte = unsigned char;
 using ByteBuffer = std::vector<byte>;
 
+/**
+ * A reference-counted, immutable ByteBuffer. Used where a buffer must stay alive until an asynchronous operation that
+ * reads from it has completed.
+ */
+using SharedByteBuffer = std::shared_ptr<const ByteBuffer>;
+
 template<size_t size>
 using ByteString = std::array<byte, size>;
 
+/**
+ * A non-owning view of a contiguous range of mutable bytes.
+ */
+struct ByteView
+{
+    byte* data;
+    size_t size;
+
+    ByteView() : data(nullptr), size(0) {}
+    ByteView(byte* data, size_t size) : data(data), size(size) {}
+    ByteView(ByteBuffer& buffer) : data(buffer.data()), size(buffer.size()) {}
+};
+
+/**
+ * A non-owning view of a contiguous range of bytes.
+ */
+struct ConstByteView
+{
+    const byte* data;
+    size_t size;
+
+    ConstByteView() : data(nullptr), size(0) {}
+    ConstByteView(const byte* data, size_t size) : data(data), size(size) {}
+    ConstByteView(const ByteBuffer& buffer) : data(buffer.data()), size(buffer.size()) {}
+    ConstByteView(const std::string& str) : data(reinterpret_cast<const byte*>(str.data())), size(str.size()) {}
+    ConstByteView(ByteView view) : data(view.data), size(view.size) {}
+
+    template<size_t N>
+    ConstByteView(const ByteString<N>& str) : data(str.data()), size(N) {}
+};
+
 std::ostream& operator<<(std::ostream& out, ByteBuffer b);
 
 template<size_t size>
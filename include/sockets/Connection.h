@@ -1,6 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
 #include "Byte.h"
 #include "TCPSocket.h"
 #include "Error.h"
@@ -10,6 +13,10 @@
 #define DEFAULT_BUFFER_CAPACITY 1400
 #endif
 
+#ifndef DEFAULT_FLUSH_THRESHOLD
+#define DEFAULT_FLUSH_THRESHOLD 65536
+#endif
+
 namespace sockets {
     namespace
     {
@@ -29,6 +36,34 @@ namespace sockets {
             if (socket.invalid())
                 throw sockets::InvalidSocketError("Connection", function_name);
         }
+
+        /**
+         * Finds the first occurrence of a delimiter in [begin, end).
+         *
+         * Candidate positions are located by scanning for the first byte of the delimiter with memchr, which the
+         * standard library implements with vector instructions, so only candidates are compared in full.
+         *
+         * @return A pointer to the first byte of the delimiter, or end if it was not found.
+         */
+        inline const byte*
+        find_delimiter(const byte* begin, const byte* end, const byte* delim, size_t delim_size)
+        {
+            while (static_cast<size_t>(end - begin) >= delim_size)
+            {
+                // Only scan positions where the whole delimiter still fits
+                size_t scan_size = static_cast<size_t>(end - begin) - delim_size + 1;
+                auto candidate = static_cast<const byte*>(std::memchr(begin, delim[0], scan_size));
+
+                if (candidate == nullptr)
+                    return end;
+                if (std::memcmp(candidate + 1, delim + 1, delim_size - 1) == 0)
+                    return candidate;
+
+                begin = candidate + 1;
+            }
+
+            return end;
+        }
     }
 
     /**
@@ -50,11 +85,256 @@ namespace sockets {
     protected:
         T _socket;
         ByteBuffer _buffer;
+        /** Bytes that were received from the network but not yet returned by a read. */
+        ByteBuffer _input;
+        /** Index of the first unread byte in _input. */
+        size_t _input_offset;
+        /** Bytes queued by a non-blocking write that have not been sent yet. */
+        ByteBuffer _output;
+        /** Index of the first unsent byte in _output. */
+        size_t _output_offset;
+        /** Number of queued bytes at which queue() flushes automatically. */
+        size_t _flush_threshold;
+        /** If true, flush() corks the socket while it sends. */
+        bool _cork_on_flush;
+        /** Time limit of each read, or zero for none. */
+        std::chrono::milliseconds _read_timeout;
+        /** Time limit of each write, or zero for none. */
+        std::chrono::milliseconds _write_timeout;
+        /** Maximum size of a message returned by read_until(), or zero for no limit. */
+        size_t _max_message_size;
         bool _closed;
+
+        using clock = std::chrono::steady_clock;
+        using waitable = std::integral_constant<bool, has_socket_handle<T>::value>;
+
+        /**
+         * Returns the point in time at which an operation with the given time limit expires, or
+         * clock::time_point::max() if the limit is zero.
+         */
+        static clock::time_point
+        deadline_after(std::chrono::milliseconds timeout)
+        {
+            return timeout.count() > 0 ? clock::now() + timeout : clock::time_point::max();
+        }
+
+        /**
+         * Waits until the socket is ready for the events, and returns false if the deadline expires first.
+         */
+        bool
+        wait_until(int events, clock::time_point deadline, std::true_type)
+        {
+            abl::PollEntry entry{&_socket.handle, events, 0};
+            while (entry.ready == 0)
+            {
+                auto now = clock::now();
+                if (now >= deadline)
+                    return false;
+
+                // Round up, so the wait does not end just before the deadline
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+                abl::poll_handles(&entry, 1, static_cast<int>(std::min<std::chrono::milliseconds::rep>(
+                        remaining, std::numeric_limits<int>::max())));
+            }
+            return true;
+        }
+
+        bool
+        wait_until(int, clock::time_point, std::false_type)
+        {
+            throw InvalidStateError("Connection", "wait_until", "timeouts require a socket with a handle member");
+        }
+
+        /**
+         * Receives up to amount bytes at the end of _buffer. Throws SocketReadError with type TIMED_OUT if no bytes
+         * arrive before the deadline.
+         */
+        size_t
+        receive(size_t amount, clock::time_point deadline, const char* function_name)
+        {
+            if (deadline == clock::time_point::max())
+                return _socket.recv(_buffer, amount, _buffer.size());
+
+            size_t offset = _buffer.size();
+            while (true)
+            {
+                if (!wait_until(abl::poll_event::READABLE, deadline, waitable()))
+                    throw SocketReadError(std::string("Connection::") + function_name, get_timed_out_code());
+
+                try {
+                    return _socket.recv(_buffer, amount, offset, abl::nonblocking_io_flag());
+                }
+                catch (SocketReadError& e)
+                {
+                    // Another reader may have taken the bytes; wait again
+                    _buffer.resize(offset);
+                    if (e.type != SocketReadError::ErrorType::WOULD_BLOCK) throw;
+                }
+            }
+        }
+
+        /**
+         * Sends up to size bytes. Throws SocketWriteError with type TIMED_OUT if the socket does not accept any
+         * bytes before the deadline.
+         */
+        size_t
+        send_some(const byte* data, size_t size, clock::time_point deadline, const char* function_name)
+        {
+            if (deadline == clock::time_point::max())
+                return static_cast<size_t>(_socket.send(data, size, 0));
+
+            while (true)
+            {
+                if (!wait_until(abl::poll_event::WRITABLE, deadline, waitable()))
+                    throw SocketWriteError(std::string("Connection::") + function_name, get_timed_out_code());
+
+                try {
+                    return static_cast<size_t>(_socket.send(data, size, abl::nonblocking_io_flag()));
+                }
+                catch (SocketWriteError& e)
+                {
+                    if (e.type != SocketWriteError::ErrorType::WOULD_BLOCK) throw;
+                }
+            }
+        }
+
+        /**
+         * Performs the same function as send_some(), for several buffers at once.
+         */
+        size_t
+        sendv_some(const ConstByteView* views, size_t count, clock::time_point deadline, const char* function_name)
+        {
+            if (deadline == clock::time_point::max())
+                return _socket.sendv(views, count, 0);
+
+            while (true)
+            {
+                if (!wait_until(abl::poll_event::WRITABLE, deadline, waitable()))
+                    throw SocketWriteError(std::string("Connection::") + function_name, get_timed_out_code());
+
+                try {
+                    return _socket.sendv(views, count, abl::nonblocking_io_flag());
+                }
+                catch (SocketWriteError& e)
+                {
+                    if (e.type != SocketWriteError::ErrorType::WOULD_BLOCK) throw;
+                }
+            }
+        }
+
+        /**
+         * Moves up to n bytes from the read-ahead buffer to the end of _buffer.
+         *
+         * @return The number of bytes moved.
+         */
+        size_t
+        take_buffered(size_t n)
+        {
+            size_t count = std::min(n, buffered());
+            if(count == 0) return 0;
+
+            auto begin = _input.cbegin() + _input_offset;
+            _buffer.insert(_buffer.end(), begin, begin + count);
+
+            _input_offset += count;
+            if(_input_offset == _input.size())
+            {
+                _input.clear();
+                _input_offset = 0;
+            }
+
+            return count;
+        }
+
+        /**
+         * Moves the bytes of _buffer back to the front of the read-ahead buffer, so a read that fails part way
+         * through does not consume them.
+         */
+        void
+        unread_buffer()
+        {
+            _buffer.insert(_buffer.end(), _input.cbegin() + _input_offset, _input.cend());
+            _input.swap(_buffer);
+            _input_offset = 0;
+            _buffer.clear();
+        }
+
+        /**
+         * Appends bytes to the output queue.
+         */
+        void
+        queue_output(const byte* data, size_t size)
+        {
+            // Drop the bytes that were already sent once they make up at least half of the queue
+            if(_output_offset > 0 && _output_offset >= _output.size() - _output_offset)
+            {
+                _output.erase(_output.begin(), _output.begin() + _output_offset);
+                _output_offset = 0;
+            }
+
+            _output.insert(_output.end(), data, data + size);
+        }
+
+        void
+        cork(bool enable, std::true_type)
+        {
+            _socket.set_cork(enable);
+        }
+
+        void
+        cork(bool, std::false_type)
+        {}
+
+        /**
+         * Corks the socket while it is in scope, if the connection corks on flush. Uncorks on every exit, so that
+         * bytes already handed to the kernel are not held back when a send throws.
+         */
+        struct CorkScope
+        {
+            Connection& connection;
+            bool corked;
+
+            explicit CorkScope(Connection& connection) : connection(connection), corked(false)
+            {
+                if (connection._cork_on_flush)
+                {
+                    connection.cork(true, std::integral_constant<bool, has_set_cork<T>::value>());
+                    corked = true;
+                }
+            }
+
+            CorkScope(const CorkScope&) = delete;
+            CorkScope& operator=(const CorkScope&) = delete;
+
+            /**
+             * Uncorks now, reporting errors to the caller.
+             */
+            void
+            release()
+            {
+                if (!corked) return;
+                corked = false;
+                connection.cork(false, std::integral_constant<bool, has_set_cork<T>::value>());
+            }
+
+            ~CorkScope()
+            {
+                // Already unwinding from a failed send; that error is the one worth reporting
+                try { release(); }
+                catch (...) {}
+            }
+        };
+
     public:
-        Connection() : _socket(), _buffer(), _closed(true) {}
+        Connection() : _socket(), _buffer(), _input(), _input_offset(0), _output(), _output_offset(0),
+                       _flush_threshold(DEFAULT_FLUSH_THRESHOLD), _cork_on_flush(false), _read_timeout(0),
+                       _write_timeout(0), _max_message_size(0), _closed(true)
+        {}
 
-        explicit Connection(T socket) : _socket(std::move(socket)), _buffer(), _closed(false)
+        explicit Connection(T socket) : _socket(std::move(socket)), _buffer(), _input(), _input_offset(0),
+                                        _output(), _output_offset(0), _flush_threshold(DEFAULT_FLUSH_THRESHOLD),
+                                        _cork_on_flush(false), _read_timeout(0), _write_timeout(0),
+                                        _max_message_size(0), _closed(false)
         {}
 
         // Delete the copy constructor
@@ -66,8 +346,14 @@ namespace sockets {
 
         // Move construction
         Connection(Connection<T>&& other) noexcept :
-        _socket(std::move(other._socket)), _buffer(std::move(other._buffer)), _closed(other._closed)
+        _socket(std::move(other._socket)), _buffer(std::move(other._buffer)), _input(std::move(other._input)),
+        _input_offset(other._input_offset), _output(std::move(other._output)), _output_offset(other._output_offset),
+        _flush_threshold(other._flush_threshold), _cork_on_flush(other._cork_on_flush),
+        _read_timeout(other._read_timeout), _write_timeout(other._write_timeout),
+        _max_message_size(other._max_message_size), _closed(other._closed)
         {
+            other._input_offset = 0;
+            other._output_offset = 0;
             other._closed = true;
         }
 
@@ -81,6 +367,20 @@ namespace sockets {
 
                 _buffer = std::move(other._buffer);
 
+                _input = std::move(other._input);
+                _input_offset = other._input_offset;
+                other._input_offset = 0;
+
+                _output = std::move(other._output);
+                _output_offset = other._output_offset;
+                other._output_offset = 0;
+
+                _flush_threshold = other._flush_threshold;
+                _cork_on_flush = other._cork_on_flush;
+                _read_timeout = other._read_timeout;
+                _write_timeout = other._write_timeout;
+                _max_message_size = other._max_message_size;
+
                 _closed = other._closed;
                 other._closed = true;
             }
@@ -88,46 +388,97 @@ namespace sockets {
         }
 
         /**
-         * Reads up to n bytes from the network.
+         * Returns the number of bytes that have been received but not yet read. These bytes are returned by the next
+         * read without a call to the network.
+         */
+        size_t
+        buffered() const
+        {
+            return _input.size() - _input_offset;
+        }
+
+        /**
+         * Reads up to n bytes from the network. If bytes are buffered, they are returned instead, without a call to
+         * the network.
          *
          * @param n Number of bytes to read.
          * @return A reference to a ByteBuffer containing the data received
          */
         ByteBuffer&
         read(size_t n)
+        {
+            return read(n, _read_timeout);
+        }
+
+        /**
+         * Performs the same function as read(), but throws SocketReadError with type TIMED_OUT if no bytes arrive
+         * within the timeout. A timeout of zero waits indefinitely.
+         */
+        ByteBuffer&
+        read(size_t n, std::chrono::milliseconds timeout)
         {
             check_connection_state(__func__, _socket, _closed);
+            auto deadline = deadline_after(timeout);
 
             // Check if the buffer needs to be cleared. This is to prevent accidentally returning old data.
             if(!_buffer.empty()) _buffer.clear();
+
+            if(take_buffered(n) > 0) return _buffer;
+
             // Ensure that the buffer has the capacity for n bytes
             _buffer.reserve(n);
 
-            _socket.recv(_buffer, n);
+            receive(n, deadline, __func__);
 
             return _buffer;
         }
 
         /**
          * Reads exactly n bytes from the network, and returns the result as a reference to a ByteBuffer.
-         * This method blocks until n bytes are read.
+         * This method blocks until n bytes are read. If the peer closes the connection first, the connection is marked
+         * as closed and ClosedError is thrown.
          *
          * @param n The number of bytes to read.
          * @return A reference to a ByteBuffer containing the data received.
          */
         ByteBuffer&
         read_exactly(size_t n)
+        {
+            return read_exactly(n, _read_timeout);
+        }
+
+        /**
+         * Performs the same function as read_exactly(), but throws SocketReadError with type TIMED_OUT if the n bytes
+         * have not all arrived within the timeout. The bytes received so far stay buffered for the following reads,
+         * so the call can be retried. A timeout of zero waits indefinitely.
+         */
+        ByteBuffer&
+        read_exactly(size_t n, std::chrono::milliseconds timeout)
         {
             check_connection_state(__func__, _socket, _closed);
+            auto deadline = deadline_after(timeout);
 
             // Check if the buffer needs to be cleared
             if(!_buffer.empty()) _buffer.clear();
             // Ensure that the buffer has the capacity for n bytes
             _buffer.reserve(n);
 
-            while (_buffer.size() < n)
+            take_buffered(n);
+
+            try {
+                while (_buffer.size() < n)
+                {
+                    if(receive(n - _buffer.size(), deadline, __func__) == 0)
+                    {
+                        _closed = true;
+                        throw ClosedError("Connection", __func__);
+                    }
+                }
+            }
+            catch (SocketReadError&)
             {
-                _socket.recv(_buffer, n - _buffer.size(), _buffer.size());
+                unread_buffer();
+                throw;
             }
 
             return _buffer;
@@ -135,7 +486,10 @@ namespace sockets {
 
         /**
          * Reads bytes from the network until a delimiter is reached, then returns all bytes read up to the end of the
-         * delimiter. Bytes read after the delimiter are discarded.
+         * delimiter. Bytes read after the delimiter are buffered for the following reads.
+         *
+         * If the peer closes the connection before the delimiter arrives, the connection is marked as closed and
+         * ClosedError is thrown. Messages longer than max_message_size() throw MessageTooLargeError and stay buffered.
          *
          * @tparam delim_size Size of the delimiter
          * @param delim The delimiter
@@ -145,37 +499,167 @@ namespace sockets {
         ByteBuffer&
         read_until(const ByteString<delim_size>& delim)
         {
+            return read_until(delim, _read_timeout, _max_message_size);
+        }
+
+        /**
+         * Performs the same function as read_until(), but throws SocketReadError with type TIMED_OUT if the delimiter
+         * has not arrived within the timeout. The bytes received so far stay buffered for the following reads, so the
+         * call can be retried. A timeout of zero waits indefinitely.
+         */
+        template<size_t delim_size>
+        ByteBuffer&
+        read_until(const ByteString<delim_size>& delim, std::chrono::milliseconds timeout)
+        {
+            return read_until(delim, timeout, _max_message_size);
+        }
+
+        /**
+         * Performs the same function as read_until(), but throws MessageTooLargeError if the message, including the
+         * delimiter, would be longer than max_bytes. No more than max_bytes are held for the message, so a peer that
+         * never sends the delimiter cannot grow the buffer without bound. A limit of zero allows any size.
+         *
+         * When MessageTooLargeError is thrown, every byte received for the message stays buffered, as if the call
+         * had not been made. The caller can then skip the message with read() or close the connection.
+         */
+        template<size_t delim_size>
+        ByteBuffer&
+        read_until(const ByteString<delim_size>& delim, size_t max_bytes)
+        {
+            return read_until(delim, _read_timeout, max_bytes);
+        }
+
+        template<size_t delim_size>
+        ByteBuffer&
+        read_until(const ByteString<delim_size>& delim, std::chrono::milliseconds timeout, size_t max_bytes)
+        {
+            static_assert(delim_size > 0, "delimiter must not be empty");
             check_connection_state(__func__, _socket, _closed);
+            auto deadline = deadline_after(timeout);
+            size_t limit = max_bytes > 0 ? max_bytes : std::numeric_limits<size_t>::max();
 
             // Check if the buffer needs to be cleared
             if(!_buffer.empty()) _buffer.clear();
 
-            size_t offset = 0;
+            // Search the buffered bytes first, since they may already contain the delimiter
+            const byte* input_begin = _input.data() + _input_offset;
+            const byte* input_end = _input.data() + _input.size();
+            const byte* buffered_needle = find_delimiter(input_begin, input_end, delim.data(), delim_size);
+            if(buffered_needle != input_end)
+            {
+                auto message_size = static_cast<size_t>(buffered_needle - input_begin) + delim_size;
+                if(message_size > limit)
+                    throw MessageTooLargeError("Connection::read_until", max_bytes);
+
+                take_buffered(message_size);
+                return _buffer;
+            }
+
+            if(buffered() >= limit)
+                throw MessageTooLargeError("Connection::read_until", max_bytes);
+
+            take_buffered(buffered());
+
+            // Index of the first byte that has not been searched yet. Searching resumes delim_size - 1 bytes before
+            // it, so that a delimiter split across two calls to recv is still found.
+            size_t searched = _buffer.size();
 
             while(true)
             {
-                size_t bytes_received = _socket.recv(_buffer, DEFAULT_BUFFER_CAPACITY, _buffer.size());
+                if(_buffer.size() >= limit)
+                {
+                    unread_buffer();
+                    throw MessageTooLargeError("Connection::read_until", max_bytes);
+                }
+
+                size_t amount = std::min<size_t>(DEFAULT_BUFFER_CAPACITY, limit - _buffer.size());
+                size_t received;
+                try {
+                    received = receive(amount, deadline, __func__);
+                }
+                catch (SocketReadError&)
+                {
+                    unread_buffer();
+                    throw;
+                }
+
+                if(received == 0)
+                {
+                    _closed = true;
+                    throw ClosedError("Connection", __func__);
+                }
 
-                // Search for a delimiter in the received bytes
-                auto needle = std::search(_buffer.begin() + offset, _buffer.end(), delim.begin(), delim.end());
+                size_t search_from = searched >= delim_size - 1 ? searched - (delim_size - 1) : 0;
+                const byte* begin = _buffer.data();
+                const byte* end = begin + _buffer.size();
+                const byte* needle = find_delimiter(begin + search_from, end, delim.data(), delim_size);
 
-                // Delimiter was not found.
-                if(needle != _buffer.end())
+                // Delimiter was found.
+                if(needle != end)
                 {
-                    // Clear the bytes after the delimiter
-                    _buffer.erase(needle + delim_size, _buffer.cend());
+                    auto message_size = static_cast<size_t>(needle - begin) + delim_size;
+
+                    // Keep the bytes after the delimiter for the following reads
+                    _input.assign(_buffer.cbegin() + message_size, _buffer.cend());
+                    _input_offset = 0;
+                    _buffer.resize(message_size);
 
                     return _buffer;
                 }
 
-                offset += bytes_received;
+                searched = _buffer.size();
+            }
+        }
+
+    protected:
+        /**
+         * Marks the connection as closed if a write failed because the peer is gone.
+         */
+        void
+        check_write_error(const SocketWriteError& e)
+        {
+            if (e.type == SocketWriteError::ErrorType::CONNECTION_RESET ||
+                e.type == SocketWriteError::ErrorType::NOT_CONNECTED    ||
+                e.type == SocketWriteError::ErrorType::CONNECTION_ABORTED)
+            {
+                _closed = true;
+            }
+        }
+
+        template<typename Iter>
+        size_t
+        write_range(Iter begin, size_t size, std::true_type)
+        {
+            return write(reinterpret_cast<const byte*>(&*begin), size);
+        }
+
+        template<typename Iter>
+        size_t
+        write_range(Iter begin, size_t size, std::false_type)
+        {
+            // Resize only if needed
+            if(_buffer.size() < size)
+                _buffer.resize(size);
+
+            try {
+                std::copy_n(begin, size, _buffer.begin());
+                return send_some(_buffer.data(), size, deadline_after(_write_timeout), "write");
+            }
+            catch (SocketWriteError& e)
+            {
+                check_write_error(e);
+                throw;
             }
         }
 
+    public:
         /**
          * Writes bytes to the connection. If the connection is closed, the connection will be marked as closed and
          * an exception will be thrown.
          *
+         * Ranges of contiguous bytes are sent directly from the caller's memory. Other ranges are copied into an
+         * internal buffer first.
+         *
          * @return The number of bytes written.
          */
         template<typename Iter>
@@ -189,36 +673,394 @@ namespace sockets {
             if(distance < 0) throw std::invalid_argument("begin and end have a negative distance");
             if(distance == 0) return 0;
 
-            // Resize only if needed
-            if(_buffer.size() < distance)
-                _buffer.resize(static_cast<size_t>(distance));
+            return write_range(begin, static_cast<size_t>(distance),
+                               std::integral_constant<bool, is_contiguous_byte_iterator<Iter>::value>());
+        }
 
+        /**
+         * Writes bytes to the connection directly from the caller's memory, without copying them.
+         *
+         * @param data Pointer to the first byte to write.
+         * @param size Number of bytes to write.
+         * @return The number of bytes written.
+         */
+        size_t
+        write(const byte* data, size_t size)
+        {
+            check_connection_state(__func__, _socket, _closed);
+            if(size == 0) return 0;
+
+            try {
+                return send_some(data, size, deadline_after(_write_timeout), __func__);
+            }
+            catch (SocketWriteError& e)
+            {
+                check_write_error(e);
+                throw;
+            }
+        }
+
+        size_t
+        write(const ByteBuffer& data)
+        {
+            return write(data.data(), data.size());
+        }
+
+        size_t
+        write(const std::string& data)
+        {
+            return write(reinterpret_cast<const byte*>(data.data()), data.size());
+        }
+
+        template<size_t data_size>
+        size_t
+        write(const ByteString<data_size> &data)
+        {
+            return write(data.data(), data_size);
+        }
+
+        /**
+         * Writes bytes to the connection directly from the caller's memory. Unlike write(), this blocks until every
+         * byte has been written.
+         *
+         * @return The number of bytes written.
+         */
+        size_t
+        write_all(const byte* data, size_t size)
+        {
+            return write_all(data, size, _write_timeout);
+        }
+
+        /**
+         * Performs the same function as write_all(), but throws SocketWriteError with type TIMED_OUT if not every
+         * byte has been written within the timeout. A timeout of zero waits indefinitely.
+         */
+        size_t
+        write_all(const byte* data, size_t size, std::chrono::milliseconds timeout)
+        {
+            check_connection_state(__func__, _socket, _closed);
+            auto deadline = deadline_after(timeout);
+
+            size_t offset = 0;
+            try {
+                while (offset < size)
+                    offset += send_some(data + offset, size - offset, deadline, __func__);
+            }
+            catch (SocketWriteError& e)
+            {
+                check_write_error(e);
+                throw;
+            }
+
+            return offset;
+        }
+
+        size_t
+        write_all(const ByteBuffer& data)
+        {
+            return write_all(data.data(), data.size());
+        }
+
+        size_t
+        write_all(const std::string& data)
+        {
+            return write_all(reinterpret_cast<const byte*>(data.data()), data.size());
+        }
+
+        /**
+         * Writes several buffers to the connection as one message, using as few system calls as possible, without
+         * concatenating them first. Blocks until every byte has been written.
+         *
+         * T must implement sendv(const ConstByteView*, size_t, int).
+         *
+         * @param views The buffers to write, in order.
+         * @param count The number of buffers.
+         * @return The number of bytes written.
+         */
+        size_t
+        write_all(const ConstByteView* views, size_t count)
+        {
+            check_connection_state(__func__, _socket, _closed);
+            auto deadline = deadline_after(_write_timeout);
+
+            size_t total = 0;
+            size_t next = 0;
 
             try {
-                std::copy(begin, end, _buffer.begin());
-                ssize_t bytes = _socket.send(_buffer, distance, 0, 0);
-                return static_cast<size_t>(bytes);
+                while (next < count)
+                {
+                    size_t bytes = sendv_some(views + next, count - next, deadline, __func__);
+                    total += bytes;
+
+                    // Skip the buffers that were written completely
+                    while (next < count && bytes >= views[next].size)
+                    {
+                        bytes -= views[next].size;
+                        ++next;
+                    }
+
+                    // Finish a partially written buffer on its own, so the caller's views never need to be copied
+                    if (next < count && bytes > 0)
+                    {
+                        ConstByteView rest(views[next].data + bytes, views[next].size - bytes);
+                        while (rest.size > 0)
+                        {
+                            size_t sent = sendv_some(&rest, 1, deadline, __func__);
+                            rest.data += sent;
+                            rest.size -= sent;
+                            total += sent;
+                        }
+                        ++next;
+                    }
+                }
+
+                return total;
             }
             catch (SocketWriteError& e)
             {
-                if (e.type == SocketWriteError::ErrorType::CONNECTION_RESET ||
-                    e.type == SocketWriteError::ErrorType::NOT_CONNECTED    ||
-                    e.type == SocketWriteError::ErrorType::CONNECTION_ABORTED)
+                check_write_error(e);
+                throw;
+            }
+        }
+
+        /**
+         * Writes each argument in order as one message. Arguments may be any type convertible to ConstByteView, such
+         * as ByteBuffer, ByteString, or std::string.
+         *
+         * @return The number of bytes written.
+         */
+        template<typename... Views>
+        typename std::enable_if<sizeof...(Views) != 0 && are_byte_views<Views...>::value, size_t>::type
+        write_all(const Views&... views)
+        {
+            const ConstByteView list[] = {ConstByteView(views)...};
+            return write_all(list, sizeof...(Views));
+        }
+
+        /**
+         * Writes as many bytes as possible without blocking, and queues the remainder to be sent by flush(). Bytes are
+         * always sent in the order they were written: if bytes are already queued, data is queued behind them.
+         *
+         * T must implement try_send(const byte*, size_t, int). Intended for sockets in non-blocking mode, typically
+         * together with an EventLoop that calls flush() when the socket becomes writable.
+         *
+         * @return The number of bytes sent immediately.
+         */
+        size_t
+        write_nonblocking(const byte* data, size_t size)
+        {
+            check_connection_state(__func__, _socket, _closed);
+
+            if (pending() > 0)
+            {
+                queue_output(data, size);
+                return 0;
+            }
+
+            size_t sent = 0;
+            try {
+                while (sent < size)
                 {
-                    _closed = true;
+                    IoResult result = _socket.try_send(data + sent, size - sent, 0);
+                    if (!result.ok()) break;
+                    sent += result.bytes;
                 }
+            }
+            catch (SocketWriteError& e)
+            {
+                check_write_error(e);
                 throw;
             }
+
+            queue_output(data + sent, size - sent);
+            return sent;
+        }
+
+        size_t
+        write_nonblocking(const ByteBuffer& data)
+        {
+            return write_nonblocking(data.data(), data.size());
+        }
+
+        size_t
+        write_nonblocking(const std::string& data)
+        {
+            return write_nonblocking(reinterpret_cast<const byte*>(data.data()), data.size());
+        }
+
+        /**
+         * Appends bytes to the output queue without sending them. Small writes are coalesced this way, and sent
+         * together by the next flush(), typically at the end of a processing tick. Once at least flush_threshold()
+         * bytes are queued, the queue is flushed automatically.
+         *
+         * Queued bytes are not sent by write() or write_all(). Call flush() before mixing them.
+         *
+         * T must implement try_send(const byte*, size_t, int).
+         */
+        void
+        queue(const byte* data, size_t size)
+        {
+            check_connection_state(__func__, _socket, _closed);
+
+            queue_output(data, size);
+            if (pending() >= _flush_threshold)
+                flush();
+        }
+
+        void
+        queue(const ByteBuffer& data)
+        {
+            queue(data.data(), data.size());
+        }
+
+        void
+        queue(const std::string& data)
+        {
+            queue(reinterpret_cast<const byte*>(data.data()), data.size());
         }
 
         template<size_t data_size>
+        void
+        queue(const ByteString<data_size>& data)
+        {
+            queue(data.data(), data_size);
+        }
+
+        /**
+         * Sets the number of queued bytes at which queue() flushes automatically.
+         */
+        void
+        set_flush_threshold(size_t threshold)
+        {
+            _flush_threshold = threshold;
+        }
+
         size_t
-        write(const ByteString<data_size> &data)
+        flush_threshold() const
         {
-            if (_buffer.size() < data_size)
-                _buffer.resize(data_size);
+            return _flush_threshold;
+        }
+
+        /**
+         * Sets the time limit of every following read, read_exactly(), and read_until(). A call that has not
+         * completed within the limit throws SocketReadError with type TIMED_OUT, which bounds how long a slow or
+         * stalled peer can occupy the caller. Zero, the default, waits indefinitely.
+         *
+         * The limit covers the whole call, not each call to the network. Waits use poll(), so T must expose its
+         * system socket as a handle member.
+         */
+        void
+        set_read_timeout(std::chrono::milliseconds timeout)
+        {
+            static_assert(has_socket_handle<T>::value, "T must provide a handle member to support timeouts");
+            _read_timeout = timeout;
+        }
+
+        std::chrono::milliseconds
+        read_timeout() const
+        {
+            return _read_timeout;
+        }
+
+        /**
+         * Sets the time limit of every following write() and write_all(). A call that has not completed within the
+         * limit throws SocketWriteError with type TIMED_OUT. Zero, the default, waits indefinitely.
+         *
+         * Does not apply to write_nonblocking() and flush(), which never block.
+         *
+         * On Windows, which has no per-call MSG_DONTWAIT, the limit only bounds the wait until the socket becomes
+         * writable. A send of more bytes than the socket buffer can take may still block past the limit there.
+         */
+        void
+        set_write_timeout(std::chrono::milliseconds timeout)
+        {
+            static_assert(has_socket_handle<T>::value, "T must provide a handle member to support timeouts");
+            _write_timeout = timeout;
+        }
+
+        std::chrono::milliseconds
+        write_timeout() const
+        {
+            return _write_timeout;
+        }
 
-            return write(data.begin(), data.end());
+        /**
+         * Sets the maximum size of a message returned by read_until(), including the delimiter. A longer message
+         * throws MessageTooLargeError, which keeps the memory held by each connection bounded. Zero, the default,
+         * allows any size.
+         */
+        void
+        set_max_message_size(size_t max_bytes)
+        {
+            _max_message_size = max_bytes;
+        }
+
+        size_t
+        max_message_size() const
+        {
+            return _max_message_size;
+        }
+
+        /**
+         * If enabled, flush() corks the socket while it sends queued bytes, so that the kernel only emits full
+         * packets, and uncorks it afterwards to push out the remainder.
+         *
+         * T must implement set_cork(bool).
+         */
+        void
+        set_cork_on_flush(bool enable)
+        {
+            static_assert(has_set_cork<T>::value, "T must provide set_cork(bool)");
+            _cork_on_flush = enable;
+        }
+
+        /**
+         * Sends queued bytes as one contiguous buffer. On a non-blocking socket, this sends as many bytes as possible
+         * without blocking. On a blocking socket, this returns once every queued byte has been sent.
+         *
+         * @return True if the queue is now empty.
+         */
+        bool
+        flush()
+        {
+            check_connection_state(__func__, _socket, _closed);
+            if (pending() == 0) return true;
+
+            try {
+                CorkScope corked(*this);
+
+                while (pending() > 0)
+                {
+                    IoResult result = _socket.try_send(_output.data() + _output_offset, pending(), 0);
+                    if (!result.ok()) break;
+                    _output_offset += result.bytes;
+                }
+
+                corked.release();
+            }
+            catch (SocketWriteError& e)
+            {
+                check_write_error(e);
+                throw;
+            }
+
+            if (_output_offset == _output.size())
+            {
+                _output.clear();
+                _output_offset = 0;
+                return true;
+            }
+
+            return false;
+        }
+
+        /**
+         * Returns the number of bytes queued by queue() or write_nonblocking() that have not been sent yet.
+         */
+        size_t
+        pending() const
+        {
+            return _output.size() - _output_offset;
         }
 
         T& get_socket()
@@ -248,10 +1090,43 @@ namespace sockets {
      * Attempts to establish a connection to the specified host on the specified port and returns a Connection
      * object if successful.
      *
+     * If the host resolves to several addresses, connection attempts are raced following Happy Eyeballs
+     * (RFC 8305): address families are interleaved, a new attempt starts every 250 milliseconds until one succeeds,
+     * and the attempts that lose are closed. An unreachable address therefore delays the connection by at most
+     * 250 milliseconds instead of the system connect timeout.
+     *
      * @param host The host to connect too.
      * @param port The port to connect on.
      * @return A connection object representing the connection.
      */
     TCPConnection connect_to(std::string host, std::string port);
+
+    /**
+     * Performs the same function as connect_to(), but gives up once the timeout expires, closing every pending
+     * attempt. Name resolution is not covered by the timeout.
+     *
+     * Throws ConnectError with type TIMED_OUT if no connection was established in time.
+     *
+     * @param host The host to connect too.
+     * @param port The port to connect on.
+     * @param timeout The maximum time to wait for a connection.
+     * @return A connection object representing the connection.
+     */
+    TCPConnection connect_to(std::string host, std::string port, std::chrono::milliseconds timeout);
+
+    /**
+     * Performs the same function as connect_to(), but sends initial_data as part of connecting. With TCP Fast Open,
+     * the data is carried in the SYN once the server has issued a cookie, which saves a round trip on every
+     * connection after the first. Useful for short-lived request/response connections.
+     *
+     * Fast Open is only used if the host resolves to a single address. Otherwise the addresses are raced like
+     * connect_to() and the data is sent once connected.
+     *
+     * @param host The host to connect too.
+     * @param port The port to connect on.
+     * @param initial_data The bytes to send. All of them are sent before returning.
+     * @return A connection object representing the connection.
+     */
+    TCPConnection connect_to(std::string host, std::string port, ConstByteView initial_data);
     //TODO: Implement Unicode overloads
 }
@@ -22,6 +22,27 @@ namespace sockets {
      */
     bool check_connection_reset();
 
+    /**
+     * @return True if the error code signifies that a non-blocking operation could not complete immediately.
+     */
+    bool check_would_block(int code = get_error_code());
+
+    /**
+     * @return True if the error code signifies that a pending connection was aborted before it could be accepted.
+     */
+    bool check_connection_aborted(int code = get_error_code());
+
+    /**
+     * @return True if the error code signifies that a connect() on a non-blocking socket was started but has not
+     * completed yet.
+     */
+    bool check_connect_in_progress(int code = get_error_code());
+
+    /**
+     * @return The system error code for an operation that timed out, for errors raised when a deadline expires.
+     */
+    int get_timed_out_code();
+
     class StringError : public std::exception
     {
     public:
@@ -70,6 +91,23 @@ namespace sockets {
         string(std::stringstream ss) const override;
     };
 
+    /**
+     * Thrown when a message read from a connection is longer than the allowed maximum
+     */
+    class MessageTooLargeError : public StringError
+    {
+    public:
+        /** Name of the function throwing the error */
+        const std::string throwing_function_name;
+        /** The maximum message size in bytes */
+        const size_t limit;
+
+        MessageTooLargeError(std::string tfn, size_t limit);
+
+        std::string
+        string(std::stringstream ss) const override;
+    };
+
     class InvalidStateError : public StringError
     {
     public:
@@ -119,7 +157,35 @@ namespace sockets {
         /** Type of error */
         const ErrorType type;
 
-        SocketReadError(std::string tfn);
+        SocketReadError(std::string tfn, int ec = get_error_code());
+
+        std::string string(std::stringstream ss) const final;
+    };
+
+    /**
+     * Thrown when a connection could not be established, including when a connection deadline expires
+     */
+    class ConnectError : public MethodError
+    {
+    public:
+        enum ErrorType
+        {
+            TIMED_OUT,
+            CONNECTION_REFUSED,
+            NETWORK_UNREACHABLE,
+            HOST_UNREACHABLE,
+            ADDRESS_IN_USE,
+            OTHER
+        };
+
+    protected:
+        ErrorType map_error_type(int code);
+
+    public:
+        /** Type of error */
+        const ErrorType type;
+
+        ConnectError(std::string tfn, int ec = get_error_code());
 
         std::string string(std::stringstream ss) const final;
     };
@@ -148,7 +214,7 @@ namespace sockets {
         /** Type of error */
         ErrorType type;
 
-        SocketWriteError(std::string tfn);
+        SocketWriteError(std::string tfn, int ec = get_error_code());
 
         std::string string(std::stringstream ss) const final;
     };
@@ -0,0 +1,160 @@
+//
+// Defines a readiness-based event loop for multiplexing many sockets on a single thread.
+//
+
+#pragma once
+
+#include "TCPSocket.h"
+#include "TCPServerSocket.h"
+#include "UnixServerSocket.h"
+#include "Connection.h"
+#include "TimerWheel.h"
+#include <functional>
+#include <memory>
+
+namespace sockets {
+
+    /**
+     * A reactor that waits for readiness events on many sockets at once and dispatches them to callbacks.
+     *
+     * Sockets are registered together with the events they are interested in. Each call to poll() waits for at
+     * least one registered socket to become ready and invokes its callback with the events that occurred.
+     *
+     * The EventLoop does not own the sockets registered with it. A socket must be removed before it is closed.
+     *
+     * This class is currently only implemented on Linux, using epoll.
+     */
+    class EventLoop
+    {
+    public:
+        enum Event : unsigned int
+        {
+            /** Data is available to read, or a connection is waiting to be accepted. */
+            READABLE = 1u << 0u,
+            /** The socket can be written to without blocking. */
+            WRITABLE = 1u << 1u,
+            /** The peer closed the connection. Only reported. */
+            HANGUP = 1u << 2u,
+            /** An error occurred on the socket. Only reported. */
+            ERROR = 1u << 3u,
+            /** Report events only when the readiness state changes, instead of while it persists. */
+            EDGE_TRIGGERED = 1u << 4u
+        };
+
+        /**
+         * Callback invoked when a registered socket becomes ready. The parameter is a mask of Event values.
+         */
+        using callback_t = std::function<void(unsigned int)>;
+
+    private:
+        struct Imp;
+        std::unique_ptr<Imp> _imp;
+
+        void add_descriptor(int descriptor, unsigned int events, callback_t callback);
+        void modify_descriptor(int descriptor, unsigned int events);
+        void remove_descriptor(int descriptor);
+
+    public:
+        /**
+         * Creates a new EventLoop.
+         *
+         * @param max_events The maximum number of events dispatched by a single call to poll().
+         */
+        explicit EventLoop(size_t max_events = 256);
+        ~EventLoop();
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+
+        /**
+         * Registers a socket with the loop.
+         *
+         * @param socket The socket to watch. It must stay alive until it is removed.
+         * @param events A mask of Event values to wait for.
+         * @param callback Called with the events that occurred each time the socket becomes ready.
+         */
+        void add(const TCPSocket& socket, unsigned int events, callback_t callback);
+
+        /**
+         * Registers a listening socket with the loop. The callback is invoked when a connection can be accepted.
+         */
+        void add(const TCPServerSocket& server, callback_t callback);
+
+        void add(const UnixStreamSocket& socket, unsigned int events, callback_t callback);
+
+        void add(const UnixServerSocket& server, callback_t callback);
+
+        template<typename T>
+        void add(Connection<T>& connection, unsigned int events, callback_t callback)
+        {
+            add(connection.get_socket(), events, std::move(callback));
+        }
+
+        /**
+         * Changes the events a registered socket is waiting for.
+         */
+        void modify(const TCPSocket& socket, unsigned int events);
+
+        void modify(const UnixStreamSocket& socket, unsigned int events);
+
+        template<typename T>
+        void modify(Connection<T>& connection, unsigned int events)
+        {
+            modify(connection.get_socket(), events);
+        }
+
+        /**
+         * Unregisters a socket. It is safe to call this from within the socket's own callback.
+         */
+        void remove(const TCPSocket& socket);
+
+        void remove(const TCPServerSocket& server);
+
+        void remove(const UnixStreamSocket& socket);
+
+        void remove(const UnixServerSocket& server);
+
+        template<typename T>
+        void remove(Connection<T>& connection)
+        {
+            remove(connection.get_socket());
+        }
+
+        /**
+         * Waits for events and dispatches them to their callbacks.
+         *
+         * If a callback throws, the remaining events of the batch are still dispatched and the socket keeps its
+         * callback. The first exception is then rethrown.
+         *
+         * @param timeout_ms Maximum time to wait in milliseconds. -1 waits indefinitely, 0 returns immediately.
+         * @return The number of events dispatched.
+         */
+        size_t poll(int timeout_ms = -1);
+
+        /**
+         * Waits for events like poll(), but no longer than until the next timer of the wheel is due, then runs the
+         * timers that expired. If an event callback throws, its exception propagates as from poll() and the timers
+         * run on the next call.
+         *
+         * @param timers The timers to run.
+         * @param timeout_ms Maximum time to wait in milliseconds. -1 waits until the next timer.
+         * @return The number of events dispatched plus the number of timers that ran.
+         */
+        size_t poll(TimerWheel& timers, int timeout_ms = -1);
+
+        /**
+         * Calls poll() repeatedly until stop() is called.
+         */
+        void run();
+
+        /**
+         * Calls poll(TimerWheel&) repeatedly until stop() is called.
+         */
+        void run(TimerWheel& timers);
+
+        /**
+         * Makes run() return after the current iteration has been dispatched.
+         */
+        void stop();
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+namespace sockets {
+
+    /**
+     * Result of a non-blocking I/O operation.
+     *
+     * Conditions that are expected during non-blocking I/O are reported through the status instead of an exception.
+     * Any other error is still thrown.
+     */
+    struct IoResult
+    {
+        enum Status
+        {
+            /** The operation transferred bytes. */
+            OK,
+            /** The operation could not be completed without blocking. No bytes were transferred. */
+            WOULD_BLOCK,
+            /** The peer has closed the connection. No bytes were transferred. */
+            CLOSED
+        };
+
+        Status status;
+        /** Number of bytes transferred */
+        size_t bytes;
+
+        bool ok() const
+        { return status == OK; }
+
+        bool would_block() const
+        { return status == WOULD_BLOCK; }
+
+        bool closed() const
+        { return status == CLOSED; }
+    };
+}
@@ -0,0 +1,180 @@
+//
+// Defines a completion-based I/O engine built on Linux io_uring.
+//
+
+#pragma once
+
+#include "TCPSocket.h"
+#include "Byte.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace sockets {
+
+    /**
+     * A completion-based I/O engine for TCPSockets built on io_uring.
+     *
+     * Operations are queued as submission entries and sent to the kernel in batches by submit() or wait(). Each
+     * operation is tagged with a caller-chosen user_data value, which is returned with its completion.
+     *
+     * Memory passed to an operation must stay valid until its completion has been reaped. The sockets passed to
+     * an operation must stay open until its completion has been reaped.
+     *
+     * This class is only available on Linux and talks to the kernel directly, without liburing.
+     */
+    class IoUring
+    {
+    public:
+        /**
+         * The result of a completed operation.
+         */
+        struct Completion
+        {
+            /** The user_data value given when the operation was queued */
+            uint64_t user_data;
+            /** The result of the operation. Negative values are a negated system error code. */
+            int result;
+            /** Completion flags reported by the kernel */
+            uint32_t flags;
+
+            /**
+             * @return True if the operation failed.
+             */
+            bool failed() const;
+
+            /**
+             * @return The system error code if the operation failed, zero otherwise.
+             */
+            int error() const;
+
+            /**
+             * @return True if this is a multishot operation that will produce more completions.
+             */
+            bool more() const;
+
+            /**
+             * @return True if the kernel selected a provided buffer for this completion.
+             */
+            bool has_buffer() const;
+
+            /**
+             * @return The id of the provided buffer selected by the kernel. Only valid if has_buffer() is true.
+             */
+            uint16_t buffer_id() const;
+
+            /**
+             * Takes ownership of the socket created by a successful accept operation.
+             */
+            TCPSocket accepted_socket() const;
+        };
+
+        using completion_handler_t = std::function<void(const Completion&)>;
+
+    private:
+        struct Imp;
+        std::unique_ptr<Imp> _imp;
+
+    public:
+        /**
+         * Creates a new ring.
+         *
+         * @param entries The number of submission entries. The kernel rounds this up to a power of two.
+         */
+        explicit IoUring(unsigned int entries = 256);
+        ~IoUring();
+
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+
+        /**
+         * Queues an accept on a listening socket.
+         *
+         * @param multishot If true, one completion is produced for every accepted connection until the operation
+         * is cancelled or fails. Requires Linux 5.19; throws InvalidStateError if the library was built against
+         * older kernel headers.
+         */
+        void accept(const TCPSocket& listener, uint64_t user_data, bool multishot = false);
+
+        /**
+         * Queues a receive of up to amount bytes into buffer, starting at offset. The buffer must already be at
+         * least offset + amount bytes large.
+         */
+        void recv(const TCPSocket& socket, ByteBuffer& buffer, size_t amount, size_t offset, uint64_t user_data);
+
+        /**
+         * Queues a send of amount bytes from buffer, starting at offset.
+         */
+        void send(const TCPSocket& socket, const ByteBuffer& buffer, size_t amount, size_t offset,
+                  uint64_t user_data);
+
+        /**
+         * Registers buffers with the kernel so that recv_fixed() and send_fixed() can skip mapping them on every
+         * operation. Replaces any previously registered buffers. The buffers must not be resized while registered.
+         */
+        void register_buffers(std::vector<ByteBuffer>& buffers);
+
+        /**
+         * Unregisters the buffers registered with register_buffers().
+         */
+        void unregister_buffers();
+
+        /**
+         * Queues a receive into the registered buffer with the given index.
+         */
+        void recv_fixed(const TCPSocket& socket, unsigned int index, size_t amount, size_t offset,
+                        uint64_t user_data);
+
+        /**
+         * Queues a send from the registered buffer with the given index.
+         */
+        void send_fixed(const TCPSocket& socket, unsigned int index, size_t amount, size_t offset,
+                        uint64_t user_data);
+
+        /**
+         * Queues an operation that gives count buffers of buffer_size bytes, laid out contiguously at base, to the
+         * kernel under the given group. Multishot receives pick buffers from the group as data arrives. A buffer
+         * selected by a completion must be provided again once it has been consumed.
+         *
+         * @param first_id The id of the first buffer. Following buffers receive consecutive ids.
+         */
+        void provide_buffers(uint16_t group, byte* base, unsigned int buffer_size, unsigned int count,
+                             uint16_t first_id, uint64_t user_data);
+
+        /**
+         * Queues a multishot receive. A completion is produced for every chunk of data received, using a buffer
+         * selected from the given group, until the connection is closed, the group runs out of buffers, or the
+         * operation is cancelled. Requires Linux 6.0; throws InvalidStateError if the library was built against
+         * older kernel headers.
+         */
+        void recv_multishot(const TCPSocket& socket, uint16_t group, uint64_t user_data);
+
+        /**
+         * Queues a request to cancel the pending operation tagged with target_user_data.
+         */
+        void cancel(uint64_t target_user_data, uint64_t user_data);
+
+        /**
+         * Sends all queued operations to the kernel.
+         *
+         * @return The number of operations submitted.
+         */
+        unsigned int submit();
+
+        /**
+         * Submits all queued operations, waits until at least min_complete completions are available, then
+         * dispatches every available completion to the handler.
+         *
+         * @return The number of completions dispatched.
+         */
+        size_t wait(unsigned int min_complete, const completion_handler_t& handler);
+
+        /**
+         * Dispatches every available completion to the handler without entering the kernel.
+         *
+         * @return The number of completions dispatched.
+         */
+        size_t reap(const completion_handler_t& handler);
+    };
+}
@@ -0,0 +1,170 @@
+//
+// Defines typed socket options for TCPSocket::set_option() and TCPSocket::get_option().
+//
+
+#pragma once
+
+#include <chrono>
+#include <type_traits>
+
+namespace sockets {
+    namespace options {
+        /** Disables Nagle's algorithm, so small writes are sent immediately (TCP_NODELAY) */
+        struct NoDelay
+        {
+            bool value;
+        };
+
+        /** The size of the send buffer in bytes (SO_SNDBUF). The system may double or round the requested size. */
+        struct SendBuffer
+        {
+            int value;
+        };
+
+        /** The size of the receive buffer in bytes (SO_RCVBUF). The system may double or round the requested size. */
+        struct ReceiveBuffer
+        {
+            int value;
+        };
+
+        /** Sends keep-alive probes on an idle connection (SO_KEEPALIVE) */
+        struct KeepAlive
+        {
+            bool value;
+        };
+
+        /** How long a connection must be idle before keep-alive probes are sent (TCP_KEEPIDLE) */
+        struct KeepIdle
+        {
+            std::chrono::seconds value;
+        };
+
+        /** The time between keep-alive probes (TCP_KEEPINTVL) */
+        struct KeepInterval
+        {
+            std::chrono::seconds value;
+        };
+
+        /** The number of unanswered keep-alive probes before the connection is dropped (TCP_KEEPCNT) */
+        struct KeepCount
+        {
+            int value;
+        };
+
+        /**
+         * Sends acknowledgements immediately instead of delaying them (TCP_QUICKACK). The system may clear this on
+         * its own, so it is usually set again after every receive. Linux only.
+         */
+        struct QuickAck
+        {
+            bool value;
+        };
+
+        /** How long a blocking receive busy-polls the device queue before sleeping (SO_BUSY_POLL). Linux only. */
+        struct BusyPoll
+        {
+            std::chrono::microseconds value;
+        };
+
+        /**
+         * The amount of unsent bytes in the send buffer above which the socket no longer reports being writable
+         * (TCP_NOTSENT_LOWAT). Keeps the send buffer short without limiting throughput.
+         */
+        struct NotSentLowat
+        {
+            int value;
+        };
+
+        /** Whether, and for how long, closing the socket waits for unsent data to be sent (SO_LINGER) */
+        struct Linger
+        {
+            bool enabled;
+            std::chrono::seconds timeout;
+        };
+
+        /** How long sent data may remain unacknowledged before the connection is dropped (TCP_USER_TIMEOUT) */
+        struct UserTimeout
+        {
+            std::chrono::milliseconds value;
+        };
+
+        /**
+         * Only sends full segments until cleared (TCP_CORK on Linux, TCP_NOPUSH on BSD systems).
+         */
+        struct Cork
+        {
+            bool value;
+        };
+
+        /**
+         * Accepts data carried in the SYN of a connection, and sets the maximum number of such connections that have
+         * not completed the handshake (TCP_FASTOPEN). Set on a listening socket before listen().
+         */
+        struct FastOpen
+        {
+            int queue_length;
+        };
+
+        /**
+         * Makes connect() return immediately, so the first send() is carried in the SYN (TCP_FASTOPEN_CONNECT).
+         * Linux only.
+         */
+        struct FastOpenConnect
+        {
+            bool value;
+        };
+
+        /** Allows binding to an address that is still in TIME_WAIT from a previous socket (SO_REUSEADDR) */
+        struct ReuseAddress
+        {
+            bool value;
+        };
+
+        /**
+         * Allows several sockets to bind to the same address and port (SO_REUSEPORT). Set on every socket before
+         * bind().
+         */
+        struct ReusePort
+        {
+            bool value;
+        };
+
+        /**
+         * Tests if T is one of the option types above.
+         * @tparam T
+         */
+        template<typename T>
+        struct is_tcp_option : std::false_type {};
+
+        template<> struct is_tcp_option<NoDelay> : std::true_type {};
+        template<> struct is_tcp_option<SendBuffer> : std::true_type {};
+        template<> struct is_tcp_option<ReceiveBuffer> : std::true_type {};
+        template<> struct is_tcp_option<KeepAlive> : std::true_type {};
+        template<> struct is_tcp_option<KeepIdle> : std::true_type {};
+        template<> struct is_tcp_option<KeepInterval> : std::true_type {};
+        template<> struct is_tcp_option<KeepCount> : std::true_type {};
+        template<> struct is_tcp_option<QuickAck> : std::true_type {};
+        template<> struct is_tcp_option<BusyPoll> : std::true_type {};
+        template<> struct is_tcp_option<NotSentLowat> : std::true_type {};
+        template<> struct is_tcp_option<Linger> : std::true_type {};
+        template<> struct is_tcp_option<UserTimeout> : std::true_type {};
+        template<> struct is_tcp_option<Cork> : std::true_type {};
+        template<> struct is_tcp_option<FastOpen> : std::true_type {};
+        template<> struct is_tcp_option<FastOpenConnect> : std::true_type {};
+        template<> struct is_tcp_option<ReuseAddress> : std::true_type {};
+        template<> struct is_tcp_option<ReusePort> : std::true_type {};
+
+        /**
+         * Tests if sockets accepted from a listening socket inherit option T from it, on Linux, the BSD systems, and
+         * Windows alike. Such options only need to be set once, on the listening socket.
+         * @tparam T
+         */
+        template<typename T>
+        struct is_inherited_on_accept : std::false_type {};
+
+        template<> struct is_inherited_on_accept<NoDelay> : std::true_type {};
+        template<> struct is_inherited_on_accept<SendBuffer> : std::true_type {};
+        template<> struct is_inherited_on_accept<ReceiveBuffer> : std::true_type {};
+        template<> struct is_inherited_on_accept<KeepAlive> : std::true_type {};
+    }
+}
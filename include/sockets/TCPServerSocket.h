@@ -6,9 +6,29 @@
 #include "TCPSocket.h"
 #include "Connection.h"
 #include "sockets/abl/ip.h"
+#include <functional>
+#include <vector>
 
 namespace sockets {
 
+    /**
+     * Options applied to a listening socket before it is bound.
+     */
+    struct ListenOptions
+    {
+        /** The maximum length of the queue of pending connections */
+        int backlog = 1024;
+        /** Allow binding to an address that is still in TIME_WAIT (SO_REUSEADDR) */
+        bool reuse_address = false;
+        /** Allow several listening sockets on the same address and port (SO_REUSEPORT) */
+        bool reuse_port = false;
+        /**
+         * If greater than 0, accept data carried in the SYN from clients using TCP Fast Open, with at most this many
+         * such connections pending (TCP_FASTOPEN). Throws InvalidStateError on systems without TCP Fast Open.
+         */
+        int fastopen_queue = 0;
+    };
+
     /**
      * Wrapper around a TCPSocket that binds to a local port and listens for incoming connections.
      */
@@ -16,6 +36,22 @@ namespace sockets {
     {
     protected:
         TCPSocket _serverSocket;
+        /** Applies the options given to set_accepted_option() to an accepted socket */
+        std::vector<std::function<void(TCPSocket&)>> _accepted_options;
+
+        TCPSocket apply_accepted_options(TCPSocket&& socket) const;
+
+        template<typename Option>
+        void set_accepted_option(const Option& option, std::true_type)
+        {
+            _serverSocket.set_option(option);
+        }
+
+        template<typename Option>
+        void set_accepted_option(const Option& option, std::false_type)
+        {
+            _accepted_options.push_back([option](TCPSocket& socket) { socket.set_option(option); });
+        }
     public:
         /**
          * Creates a new TCPServerSocket bound to the specified ip address
@@ -24,7 +60,70 @@ namespace sockets {
         explicit TCPServerSocket(const abl::IpAddress& addr, int backlog = 1024);
         TCPServerSocket(const std::string& ip, const std::string& port, int backlog = 1024);
 
+        TCPServerSocket(const abl::IpAddress& addr, const ListenOptions& options);
+        TCPServerSocket(const std::string& ip, const std::string& port, const ListenOptions& options);
+
+        /**
+         * Adopts a socket that is already bound and listening, such as one received from another process with
+         * UnixStreamSocket::recv_handles(). Connections waiting in its queue are kept.
+         */
+        explicit TCPServerSocket(TCPSocket&& listening);
+
         TCPConnection accept() const;
         std::tuple<TCPConnection, abl::IpAddress> acceptfrom() const;
+
+        /**
+         * Accepts pending connections until the queue is empty or max connections have been accepted, and applies the
+         * options given to set_accepted_option() to each. The listening socket must be in non-blocking mode,
+         * otherwise this blocks once the queue is empty. See TCPSocket::accept_batch().
+         *
+         * @param max The maximum number of connections to accept.
+         * @param nonblocking If true, the new sockets are in non-blocking mode.
+         * @return The accepted connections and the addresses of their clients.
+         */
+        std::vector<std::tuple<TCPConnection, abl::IpAddress>>
+        accept_batch(size_t max, bool nonblocking = true) const;
+
+        /**
+         * Enables or disables non-blocking mode on the listening socket, as required by accept_batch().
+         */
+        void set_nonblocking(bool nonblocking);
+
+        /**
+         * Returns the underlying listening socket.
+         */
+        const TCPSocket& get_socket() const;
+
+        /**
+         * Sets a socket option on every connection accepted from now on. Option must be one of the types in
+         * sockets::options.
+         *
+         * Options that accepted sockets inherit (see options::is_inherited_on_accept) are set once on the listening
+         * socket, at no cost per connection. Connections that are already waiting in the queue may not inherit them.
+         * Other options are set on each socket after it is accepted.
+         */
+        template<typename Option>
+        typename std::enable_if<options::is_tcp_option<Option>::value>::type
+        set_accepted_option(const Option& option)
+        {
+            set_accepted_option(option, std::integral_constant<bool, options::is_inherited_on_accept<Option>::value>());
+        }
+
+        /**
+         * Opens count listening sockets on the same address with SO_REUSEPORT, so that the system balances incoming
+         * connections across them. Give each worker thread its own listener to accept from, instead of sharing one.
+         *
+         * If the port of addr is 0, all listeners share the port chosen by the system for the first one.
+         *
+         * @param addr The address to bind too.
+         * @param count The number of listeners to open.
+         * @param options Options for every listener. reuse_port is always enabled.
+         */
+        static std::vector<TCPServerSocket>
+        open_group(const abl::IpAddress& addr, size_t count, ListenOptions options = ListenOptions());
+
+        static std::vector<TCPServerSocket>
+        open_group(const std::string& ip, const std::string& port, size_t count,
+                   ListenOptions options = ListenOptions());
     };
 }
\ No newline at end of file
@@ -6,15 +6,24 @@
 
 #include "sockets/abl/handle.h"
 #include "sockets/abl/ip.h"
+#include "sockets/abl/stream.h"
 #include "Byte.h"
+#include "IoResult.h"
+#include "SocketOption.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string>
 #include <tuple>
 #include <memory>
+#include <vector>
 
 namespace sockets
 {
     struct TCPSocket
     {
-        abl::UniqueHandle handle;
+        abl::SocketHandle handle;
 
         TCPSocket();
 
@@ -22,13 +31,20 @@ namespace sockets
          * Constructs a new TCPSocket object by moving the handle
          * @param socket
          */
+        explicit TCPSocket(abl::SocketHandle&& socket);
+
+        /**
+         * Constructs a new TCPSocket object by taking the system socket owned by the handle
+         * @param socket
+         */
         explicit TCPSocket(abl::UniqueHandle&& socket);
 
         /**
          * Constructs a new TCPSocket object by creating a new socket
          * @param fam
+         * @param nonblocking If true, the socket is created in non-blocking mode.
          */
-        explicit TCPSocket(abl::ip_family fam);
+        explicit TCPSocket(abl::ip_family fam, bool nonblocking = false);
 
         bool operator==(TCPSocket& other);
 
@@ -37,16 +53,69 @@ namespace sockets
          */
         bool invalid() const;
 
+        /**
+         * Enables or disables non-blocking mode.
+         *
+         * In non-blocking mode, operations that cannot complete immediately fail instead of waiting. Use try_recv()
+         * and try_send() to handle this without exceptions.
+         */
+        void set_nonblocking(bool nonblocking);
+
+        /**
+         * Enables or disables corking. While corked, the system only sends full segments, so several small sends are
+         * combined into as few packets as possible. Uncorking sends any remaining partial segment.
+         *
+         * Uses TCP_CORK on Linux and TCP_NOPUSH on BSD systems. Has no effect on other systems.
+         */
+        void set_cork(bool cork);
+
+        /**
+         * Allows binding to an address that is still in TIME_WAIT from a previous socket (SO_REUSEADDR). Same as
+         * set_option(options::ReuseAddress{reuse}).
+         */
+        void set_reuse_address(bool reuse);
+
+        /**
+         * Allows several sockets to bind to the same address and port (SO_REUSEPORT). The system balances incoming
+         * connections across all listening sockets bound this way. Every socket must enable this before binding.
+         *
+         * Same as set_option(options::ReusePort{reuse}). Throws InvalidStateError on systems without SO_REUSEPORT.
+         */
+        void set_reuse_port(bool reuse);
+
+        /**
+         * Sets a socket option. Option must be one of the types in sockets::options, for example
+         * set_option(options::NoDelay{true}).
+         *
+         * Throws InvalidStateError if the option is not supported on this system.
+         */
+        template<typename Option>
+        typename std::enable_if<options::is_tcp_option<Option>::value>::type
+        set_option(const Option& option);
+
+        /**
+         * Returns the current value of a socket option. Option must be one of the types in sockets::options.
+         *
+         * Throws InvalidStateError if the option is not supported on this system.
+         */
+        template<typename Option>
+        typename std::enable_if<options::is_tcp_option<Option>::value, Option>::type
+        get_option() const;
+
         /**
          * Accepts the first incoming connection and creates a new connected socket.
          *
          * This method will only work if the socket has been bound, and has been marked as passive
          * with listen().
          *
+         * The new socket is not inherited by child processes. Where the system supports accept4(), it is configured
+         * by the same system call that creates it.
+         *
+         * @param nonblocking If true, the new socket is in non-blocking mode.
          * @return A new TCPSocket.
          */
         TCPSocket
-        accept() const;
+        accept(bool nonblocking = false) const;
 
         /**
          * Performs the same function as accept(), but also returns the address of the connected client.
@@ -54,7 +123,22 @@ namespace sockets
          * @return A tuple with a TCPSocket and an instance of IpAddress.
          */
         std::tuple<TCPSocket, abl::IpAddress>
-        acceptfrom() const;
+        acceptfrom(bool nonblocking = false) const;
+
+        /**
+         * Accepts pending connections until the queue is empty or max connections have been accepted. The socket
+         * must be in non-blocking mode, otherwise this blocks once the queue is empty.
+         *
+         * Connections that were reset before they could be accepted are skipped. If accepting fails for another
+         * reason after some connections were accepted, those connections are returned and the error is left for
+         * the next call.
+         *
+         * @param max The maximum number of connections to accept.
+         * @param nonblocking If true, the new sockets are in non-blocking mode.
+         * @return The accepted sockets and the addresses of their clients.
+         */
+        std::vector<std::tuple<TCPSocket, abl::IpAddress>>
+        accept_batch(size_t max, bool nonblocking = true) const;
 
         /**
          * Binds the socket to an address.
@@ -70,6 +154,50 @@ namespace sockets
          */
         void connect(const abl::IpAddress& addr);
 
+        /**
+         * Connects the socket to an address, giving up once the timeout expires. The connection is made in
+         * non-blocking mode, and the socket is returned to its previous mode however the call ends.
+         *
+         * Throws ConnectError, with type TIMED_OUT if the timeout expired.
+         *
+         * @param addr The address to connect to.
+         * @param timeout The maximum time to wait for the connection.
+         */
+        void connect(const abl::IpAddress& addr, std::chrono::milliseconds timeout);
+
+        /**
+         * Connects the socket to an address and sends the first bytes in the same step. With TCP Fast Open
+         * (MSG_FASTOPEN), the bytes are carried in the SYN when the server has issued a cookie, which saves a
+         * round trip. Elsewhere, or when the system has Fast Open disabled, this is connect() followed by send().
+         *
+         * Throws ConnectError if the connection fails, like connect().
+         *
+         * @param addr The address to connect to.
+         * @param data Pointer to the first byte to send.
+         * @param amount The number of bytes to send.
+         * @param flags Flags to pass to the system.
+         * @return The number of bytes sent, which may be less than amount. 0 if the socket is non-blocking and the
+         * connection is still in progress; send the data once the socket becomes writable.
+         */
+        size_t
+        connect_send(const abl::IpAddress& addr, const byte* data, size_t amount, int flags = 0);
+
+        /**
+         * Starts connecting the socket to an address without waiting for the connection to complete. The socket
+         * should be in non-blocking mode. Wait for the socket to become writable, then call take_error() to learn
+         * whether the connection succeeded.
+         *
+         * @param addr The address to connect to.
+         * @return True if the connection completed immediately; false if it is in progress.
+         */
+        bool start_connect(const abl::IpAddress& addr);
+
+        /**
+         * Returns and clears the pending error of the socket (SO_ERROR), for example the result of a connection
+         * started with start_connect(). Returns 0 if there is no error.
+         */
+        int take_error();
+
         /**
          * Marks the socket as passive, indicating it will be used for incoming connections.
          *
@@ -106,5 +234,145 @@ namespace sockets
 
         size_t
         send(const ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+
+        /**
+         * Sends bytes directly from the caller's memory.
+         *
+         * @param data Pointer to the first byte to send.
+         * @param amount The number of bytes to send.
+         * @param flags Flags to pass to the system.
+         *
+         * @return The number of bytes sent
+         */
+        size_t
+        send(const byte* data, size_t amount, int flags = 0) const;
+
+        /**
+         * Sends several buffers with a single system call, in order, without concatenating them first.
+         *
+         * Like send(), this may send fewer bytes than the total size of the buffers. At most MAX_VECTORS buffers are
+         * passed to the system per call.
+         *
+         * @param views The buffers to send.
+         * @param count The number of buffers.
+         * @param flags Flags to pass to the system.
+         * @return The number of bytes sent.
+         */
+        size_t
+        sendv(const ConstByteView* views, size_t count, int flags = 0) const;
+
+        size_t
+        sendv(std::initializer_list<ConstByteView> views, int flags = 0) const;
+
+        size_t
+        sendv(const std::vector<ConstByteView>& views, int flags = 0) const;
+
+        /**
+         * Receives into several buffers with a single system call, filling each buffer before moving on to the next.
+         * The buffers are not resized.
+         *
+         * @return The number of bytes received.
+         */
+        size_t
+        recvv(const ByteView* views, size_t count, int flags = 0) const;
+
+        size_t
+        recvv(std::initializer_list<ByteView> views, int flags = 0) const;
+
+        /** The maximum number of buffers passed to the system by one call to sendv() or recvv() */
+        static const size_t MAX_VECTORS = abl::MAX_STREAM_VECTORS;
+
+#ifdef __linux__
+        /**
+         * Sends bytes from an open file without copying them through user space.
+         *
+         * Like send(), this may send fewer bytes than requested.
+         *
+         * @param file_descriptor A file descriptor opened for reading.
+         * @param offset The position in the file to start reading at.
+         * @param amount The maximum number of bytes to send.
+         * @return The number of bytes sent.
+         */
+        size_t
+        sendfile(int file_descriptor, size_t offset, size_t amount) const;
+
+        /**
+         * Sends bytes from a file without copying them through user space. Blocks until amount bytes have been sent,
+         * or the end of the file is reached.
+         *
+         * @param path The path of the file to send.
+         * @param offset The position in the file to start reading at.
+         * @param amount The maximum number of bytes to send. By default, the rest of the file is sent.
+         * @return The number of bytes sent.
+         */
+        size_t
+        sendfile(const std::string& path, size_t offset = 0, size_t amount = SIZE_MAX) const;
+
+        /**
+         * Allows the socket to send with send_zerocopy().
+         */
+        void enable_zerocopy();
+
+        /**
+         * Sends bytes without copying them into the kernel. The memory must not be modified or freed until a
+         * completion notification for this send has been received with reap_zerocopy().
+         *
+         * The system numbers every zero-copy send that transfers bytes, starting at 0, per socket. Completion
+         * notifications refer to these numbers.
+         *
+         * @return The number of bytes sent.
+         */
+        size_t
+        send_zerocopy(const byte* data, size_t amount, int flags = 0) const;
+
+        /**
+         * Callback for reap_zerocopy(). Receives an inclusive range of completed send numbers, and whether the
+         * system fell back to copying the data for them.
+         */
+        using zerocopy_handler_t = std::function<void(uint32_t first, uint32_t last, bool copied)>;
+
+        /**
+         * Reads every pending zero-copy completion notification without blocking and passes it to the handler.
+         *
+         * @return The number of notifications read.
+         */
+        size_t
+        reap_zerocopy(const zerocopy_handler_t& handler) const;
+#endif
+
+        /**
+         * Performs the same function as recv(), but reports a read that would block, and a closed connection, through
+         * the returned status instead of throwing. Intended for sockets in non-blocking mode.
+         *
+         * The buffer is resized to offset + IoResult::bytes.
+         */
+        IoResult
+        try_recv(ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+
+        /**
+         * Performs the same function as send(), but reports a write that would block through the returned status
+         * instead of throwing. Intended for sockets in non-blocking mode.
+         */
+        IoResult
+        try_send(const ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+
+        IoResult
+        try_send(const byte* data, size_t amount, int flags = 0) const;
     };
+
+#ifdef __linux__
+    /**
+     * Moves bytes received on one socket to another socket without copying them through user space. Blocks until
+     * amount bytes have been moved, or the sending peer of from closes the connection.
+     *
+     * Both sockets must be in blocking mode.
+     *
+     * @param from The socket to receive from.
+     * @param to The socket to send to.
+     * @param amount The maximum number of bytes to move. By default, bytes are moved until the connection is closed.
+     * @return The number of bytes moved.
+     */
+    size_t
+    relay(const TCPSocket& from, const TCPSocket& to, size_t amount = SIZE_MAX);
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,152 @@
+//
+// Defines a hierarchical timing wheel for managing large numbers of timeouts.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace sockets {
+
+    /**
+     * Schedules callbacks to run after a delay, for example idle, keep-alive, or request timeouts of many
+     * connections.
+     *
+     * Scheduling, rescheduling, and cancelling a timer take constant time, regardless of the number of timers.
+     * Timers are kept in four levels of 256 slots each. A timer is placed in the level whose span covers its delay,
+     * and moves to a finer level as its expiry approaches. Each tick of advance() therefore only touches the timers
+     * that are due, instead of checking every timer.
+     *
+     * Time advances only when advance() is called, in steps of the resolution. A timer runs on the first call to
+     * advance() at or after its expiry, so it may run up to one resolution late, but never early. Delays are
+     * measured from the time the timer is scheduled, however long ago advance() was last called.
+     *
+     * To drive timers from an EventLoop, use EventLoop::poll(TimerWheel&) or EventLoop::run(TimerWheel&), which
+     * wait no longer than next_timeout_ms().
+     *
+     * This class is not thread-safe.
+     */
+    class TimerWheel
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+        using callback_t = std::function<void()>;
+
+        /**
+         * Identifies a scheduled timer. An identifier stays unique after its timer has run or been cancelled, so a
+         * stale identifier never refers to a newer timer.
+         */
+        using timer_id = uint64_t;
+
+        /** An identifier that never refers to a timer */
+        static const timer_id INVALID_TIMER = 0;
+
+    protected:
+        static const size_t LEVELS = 4;
+        static const size_t SLOT_BITS = 8;
+        static const size_t SLOTS = size_t(1) << SLOT_BITS;
+        static const uint32_t NIL = UINT32_MAX;
+
+        struct Node
+        {
+            callback_t callback;
+            /** The tick at which the timer runs */
+            uint64_t expiry;
+            /** Neighbours in the slot's list, or in the free list */
+            uint32_t prev;
+            uint32_t next;
+            /** Incremented whenever the node is freed, to invalidate old identifiers */
+            uint32_t generation;
+            /** The slot the node is linked into, or NIL if it is free */
+            uint32_t slot;
+        };
+
+        clock::time_point _start;
+        clock::duration _resolution;
+        /** The last tick that has been processed */
+        uint64_t _current;
+        std::vector<Node> _nodes;
+        /** First node of each slot, level by level */
+        std::vector<uint32_t> _slots;
+        /** First node of the free list */
+        uint32_t _free;
+        size_t _size;
+        /** Number of timers in the first level */
+        size_t _level0_size;
+
+        uint64_t to_tick(clock::time_point time) const;
+        uint64_t expiry_after(clock::time_point now, std::chrono::milliseconds delay) const;
+        uint32_t allocate();
+        void release(uint32_t index);
+        void link(uint32_t index);
+        void unlink(uint32_t index);
+        /** Moves the timers of a slot to the levels matching their remaining delay */
+        void cascade(size_t level, size_t slot);
+        size_t run_slot(size_t slot);
+
+        Node* find(timer_id id);
+
+    public:
+        /**
+         * Creates an empty wheel.
+         *
+         * @param resolution The length of one tick. Timers run up to this much later than requested.
+         * @param start The time of tick 0.
+         */
+        explicit TimerWheel(std::chrono::milliseconds resolution = std::chrono::milliseconds(1),
+                            clock::time_point start = clock::now());
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        /**
+         * Schedules a callback to run once after a delay. The callback may schedule and cancel timers.
+         *
+         * @param delay The delay, measured from now.
+         * @param callback The function to run.
+         * @param now The current time.
+         * @return An identifier for cancel() and reschedule().
+         */
+        timer_id schedule(std::chrono::milliseconds delay, callback_t callback, clock::time_point now = clock::now());
+
+        /**
+         * Moves a pending timer to a new expiry, keeping its callback. Use this to push back an idle timeout on
+         * every bit of activity.
+         *
+         * @param delay The new delay, measured from now.
+         * @param now The current time.
+         * @return True if the timer was pending; false if it already ran or was cancelled.
+         */
+        bool reschedule(timer_id id, std::chrono::milliseconds delay, clock::time_point now = clock::now());
+
+        /**
+         * Cancels a pending timer.
+         *
+         * @return True if the timer was pending; false if it already ran or was cancelled.
+         */
+        bool cancel(timer_id id);
+
+        /**
+         * Runs every timer that expired at or before now, in order of expiry.
+         *
+         * @return The number of timers that ran.
+         */
+        size_t advance(clock::time_point now = clock::now());
+
+        /**
+         * Returns how long a readiness loop may wait before it must call advance() again, in milliseconds, or -1 if
+         * no timer is pending. The result may be earlier than the next expiry, but never later.
+         */
+        int next_timeout_ms(clock::time_point now = clock::now()) const;
+
+        /**
+         * Returns the number of pending timers.
+         */
+        size_t size() const;
+
+        bool empty() const;
+    };
+}
@@ -0,0 +1,183 @@
+//
+// Defines a datagram socket for UDP.
+//
+
+#pragma once
+
+#include "sockets/abl/handle.h"
+#include "sockets/abl/ip.h"
+#include "Byte.h"
+#include <cstdint>
+#include <tuple>
+
+namespace sockets
+{
+    /**
+     * A datagram to receive with UDPSocket::recv_many().
+     */
+    struct Datagram
+    {
+        /** The buffer to receive into. After receiving, size is the number of bytes received. */
+        ByteView data;
+        /** The address the datagram was received from */
+        abl::IpAddress address;
+    };
+
+    /**
+     * A datagram to send with UDPSocket::send_many().
+     */
+    struct OutgoingDatagram
+    {
+        /** The bytes to send */
+        ConstByteView data;
+        /** The address to send to. Leave the family as ANY to send to the connected address. */
+        abl::IpAddress address;
+    };
+
+    struct UDPSocket
+    {
+        abl::SocketHandle handle;
+
+        UDPSocket();
+
+        /**
+         * Constructs a new UDPSocket object by moving the handle
+         * @param socket
+         */
+        explicit UDPSocket(abl::SocketHandle&& socket);
+
+        /**
+         * Constructs a new UDPSocket object by creating a new socket
+         * @param fam
+         * @param nonblocking If true, the socket is created in non-blocking mode.
+         */
+        explicit UDPSocket(abl::ip_family fam, bool nonblocking = false);
+
+        /**
+         * Returns true if the socket is invalid; false otherwise.
+         */
+        bool invalid() const;
+
+        /**
+         * Enables or disables non-blocking mode.
+         */
+        void set_nonblocking(bool nonblocking);
+
+        /**
+         * Binds the socket to an address.
+         *
+         * @param addr The address to bind too.
+         */
+        void bind(const abl::IpAddress& addr);
+
+        /**
+         * Sets the default destination of the socket, and only receive datagrams from that address.
+         *
+         * @param addr
+         */
+        void connect(const abl::IpAddress& addr);
+
+        /**
+         * Returns the address that the socket is bound too.
+         *
+         * @return
+         */
+        abl::IpAddress getsockname() const;
+
+        /**
+         * Sends one datagram to an address.
+         *
+         * @param data Pointer to the first byte to send.
+         * @param amount The size of the datagram.
+         * @param to The address to send to.
+         * @param flags Flags to pass to the system.
+         * @return The number of bytes sent.
+         */
+        size_t
+        sendto(const byte* data, size_t amount, const abl::IpAddress& to, int flags = 0) const;
+
+        size_t
+        sendto(const ByteBuffer& buffer, const abl::IpAddress& to, int flags = 0) const;
+
+        /**
+         * Receives one datagram into the ByteBuffer. Resizes the buffer to the appropriate size. If the datagram is
+         * larger than amount, the rest of it is discarded.
+         *
+         * @param buffer The buffer to write too.
+         * @param amount The maximum amount of bytes to read.
+         * @param offset The index in the buffer to start writing at.
+         * @param flags Flags to pass to the system.
+         * @return A tuple with the number of bytes read and the address the datagram was sent from.
+         */
+        std::tuple<size_t, abl::IpAddress>
+        recvfrom(ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+
+        /**
+         * Receives up to count datagrams with as few system calls as possible. Blocks until at least one datagram is
+         * available, unless the socket is in non-blocking mode.
+         *
+         * Uses recvmmsg() where available, so a single system call fills the whole batch. Elsewhere only one
+         * datagram is received per call.
+         *
+         * @param datagrams The datagrams to receive into. The size of each buffer is updated to the size received.
+         * @param count The number of datagrams.
+         * @param flags Flags to pass to the system.
+         * @return The number of datagrams received, or 0 if the socket is non-blocking and no datagram is available.
+         */
+        size_t
+        recv_many(Datagram* datagrams, size_t count, int flags = 0) const;
+
+        /**
+         * Sends up to count datagrams with as few system calls as possible.
+         *
+         * Uses sendmmsg() where available, so a single system call sends the whole batch. Elsewhere datagrams are
+         * sent one by one.
+         *
+         * @param datagrams The datagrams to send.
+         * @param count The number of datagrams.
+         * @param flags Flags to pass to the system.
+         * @return The number of datagrams sent, which may be less than count if the socket is non-blocking.
+         */
+        size_t
+        send_many(const OutgoingDatagram* datagrams, size_t count, int flags = 0) const;
+
+        /** The maximum number of datagrams passed to the system by one call to recv_many() or send_many() */
+        static const size_t MAX_BATCH = 64;
+
+#ifdef __linux__
+        /**
+         * Sends a large buffer as a series of datagrams of segment_size bytes with one system call, letting the
+         * system or the network card split it (UDP_SEGMENT). The last datagram may be shorter.
+         *
+         * The buffer may hold at most 64 segments and must fit in a single IP packet of 64 KiB.
+         *
+         * @param data Pointer to the first byte to send.
+         * @param amount The total number of bytes to send.
+         * @param segment_size The size of each datagram.
+         * @param to The address to send to. Leave the family as ANY to send to the connected address.
+         * @param flags Flags to pass to the system.
+         * @return The number of bytes sent.
+         */
+        size_t
+        send_segmented(const byte* data, size_t amount, uint16_t segment_size,
+                       const abl::IpAddress& to = abl::IpAddress(), int flags = 0) const;
+
+        /**
+         * Allows the system to coalesce consecutive datagrams from the same sender into one larger buffer
+         * (UDP_GRO). Use recv_coalesced() to learn where the original datagrams begin.
+         */
+        void enable_gro(bool enable = true);
+
+        /**
+         * Receives into the ByteBuffer like recvfrom(), but also reports the size of the datagrams that were
+         * coalesced into it. Every datagram except the last has this size. Resizes the buffer to the appropriate
+         * size.
+         *
+         * @return A tuple with the number of bytes read, the size of each coalesced datagram, and the address the
+         * datagrams were sent from. The segment size equals the number of bytes read if nothing was coalesced.
+         */
+        std::tuple<size_t, size_t, abl::IpAddress>
+        recv_coalesced(ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+#endif
+    };
+}
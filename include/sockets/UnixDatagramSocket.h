@@ -0,0 +1,111 @@
+//
+// Defines a connectionless local (unix domain) socket.
+//
+
+#pragma once
+
+#include "sockets/abl/handle.h"
+#include "sockets/abl/local.h"
+#include "Byte.h"
+#include <tuple>
+
+namespace sockets
+{
+    /**
+     * A datagram socket between processes on the same host. Unlike UDP, local datagrams are reliable and are
+     * delivered in order, and a send blocks while the receiver's queue is full.
+     *
+     * A socket must be bound to a path before it can receive replies to the datagrams it sends.
+     *
+     * This class is only available on Unix systems.
+     */
+    struct UnixDatagramSocket
+    {
+        abl::SocketHandle handle;
+
+        UnixDatagramSocket();
+
+        /**
+         * Constructs a new UnixDatagramSocket object by moving the handle
+         * @param socket
+         */
+        explicit UnixDatagramSocket(abl::SocketHandle&& socket);
+
+        /**
+         * Creates a new socket.
+         *
+         * @param nonblocking If true, the socket is created in non-blocking mode.
+         */
+        static UnixDatagramSocket
+        open(bool nonblocking = false);
+
+        /**
+         * Creates a pair of sockets that are connected to each other. Both are close-on-exec.
+         */
+        static std::tuple<UnixDatagramSocket, UnixDatagramSocket>
+        pair();
+
+        /**
+         * Returns true if the socket is invalid; false otherwise.
+         */
+        bool invalid() const;
+
+        /**
+         * Enables or disables non-blocking mode.
+         */
+        void set_nonblocking(bool nonblocking);
+
+        /**
+         * Binds the socket to a path. The path must not exist.
+         *
+         * @param addr The address to bind too.
+         */
+        void bind(const abl::LocalAddress& addr);
+
+        /**
+         * Sets the default destination of the socket, and only receive datagrams from that address.
+         *
+         * @param addr
+         */
+        void connect(const abl::LocalAddress& addr);
+
+        /**
+         * Returns the address that the socket is bound too.
+         */
+        abl::LocalAddress getsockname() const;
+
+        /**
+         * Sends one datagram to an address.
+         *
+         * @param data Pointer to the first byte to send.
+         * @param amount The size of the datagram.
+         * @param to The address to send to.
+         * @param flags Flags to pass to the system.
+         * @return The number of bytes sent.
+         */
+        size_t
+        sendto(const byte* data, size_t amount, const abl::LocalAddress& to, int flags = 0) const;
+
+        /**
+         * Sends one datagram to the connected address.
+         *
+         * @return The number of bytes sent.
+         */
+        size_t
+        send(const byte* data, size_t amount, int flags = 0) const;
+
+        /**
+         * Receives one datagram into the ByteBuffer. Resizes the buffer to the appropriate size. If the datagram is
+         * larger than amount, the rest of it is discarded.
+         *
+         * @param buffer The buffer to write too.
+         * @param amount The maximum amount of bytes to read.
+         * @param offset The index in the buffer to start writing at.
+         * @param flags Flags to pass to the system.
+         * @return A tuple with the number of bytes read and the address the datagram was sent from, which is
+         * unnamed if the sender is not bound.
+         */
+        std::tuple<size_t, abl::LocalAddress>
+        recvfrom(ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+    };
+}
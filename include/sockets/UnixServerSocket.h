@@ -0,0 +1,41 @@
+//
+// Defines a server socket that listens on a local (unix domain) socket path.
+//
+
+#pragma once
+
+#include "UnixStreamSocket.h"
+#include "sockets/abl/local.h"
+
+namespace sockets {
+
+    /**
+     * Wrapper around a UnixStreamSocket that binds to a path and listens for incoming connections.
+     *
+     * This class is only available on Unix systems.
+     */
+    class UnixServerSocket
+    {
+    protected:
+        UnixStreamSocket _serverSocket;
+    public:
+        /**
+         * Creates a new UnixServerSocket bound to the specified path.
+         *
+         * If the path is a stale socket that nobody listens on anymore, such as one left behind by a previous run
+         * of the server, it is removed first. The path is not removed when the server is destroyed.
+         *
+         * @param addr
+         * @param type Either STREAM or SEQPACKET.
+         */
+        explicit UnixServerSocket(const abl::LocalAddress& addr, int backlog = 1024,
+                                  abl::sock_type type = abl::sock_type::STREAM);
+
+        UnixConnection accept() const;
+
+        /**
+         * Returns the underlying listening socket.
+         */
+        const UnixStreamSocket& get_socket() const;
+    };
+}
@@ -0,0 +1,228 @@
+//
+// Defines a connection-oriented local (unix domain) socket.
+//
+
+#pragma once
+
+#include "sockets/abl/handle.h"
+#include "sockets/abl/local.h"
+#include "sockets/abl/stream.h"
+#include "Byte.h"
+#include "Connection.h"
+#include "IoResult.h"
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace sockets
+{
+    /**
+     * A connection-oriented socket between processes on the same host. Local sockets skip the network stack
+     * entirely, so they are considerably faster than loopback TCP.
+     *
+     * The socket type is either STREAM, for a byte stream like TCP, or SEQPACKET, which also preserves the boundaries
+     * of every send.
+     *
+     * This class is only available on Unix systems.
+     */
+    struct UnixStreamSocket
+    {
+        abl::SocketHandle handle;
+
+        UnixStreamSocket();
+
+        /**
+         * Constructs a new UnixStreamSocket object by moving the handle
+         * @param socket
+         */
+        explicit UnixStreamSocket(abl::SocketHandle&& socket);
+
+        /**
+         * Constructs a new UnixStreamSocket object by creating a new socket
+         * @param type Either STREAM or SEQPACKET.
+         * @param nonblocking If true, the socket is created in non-blocking mode.
+         */
+        explicit UnixStreamSocket(abl::sock_type type, bool nonblocking = false);
+
+        /**
+         * Creates a pair of sockets that are connected to each other. Both are close-on-exec.
+         *
+         * @param type Either STREAM or SEQPACKET.
+         */
+        static std::tuple<UnixStreamSocket, UnixStreamSocket>
+        pair(abl::sock_type type = abl::sock_type::STREAM);
+
+        bool operator==(UnixStreamSocket& other);
+
+        /**
+         * Returns true if the socket is invalid; false otherwise.
+         */
+        bool invalid() const;
+
+        /**
+         * Enables or disables non-blocking mode.
+         */
+        void set_nonblocking(bool nonblocking);
+
+        /**
+         * Accepts the first incoming connection and creates a new connected socket, which is close-on-exec.
+         *
+         * This method will only work if the socket has been bound, and has been marked as passive
+         * with listen().
+         *
+         * @return A new UnixStreamSocket.
+         */
+        UnixStreamSocket
+        accept() const;
+
+        /**
+         * Binds the socket to a path. The path must not exist.
+         *
+         * @param addr The address to bind too.
+         */
+        void bind(const abl::LocalAddress& addr);
+
+        /**
+         * Connects the socket to a path.
+         *
+         * @param addr
+         */
+        void connect(const abl::LocalAddress& addr);
+
+        /**
+         * Marks the socket as passive, indicating it will be used for incoming connections.
+         *
+         * @param backlog
+         */
+        void listen(int backlog);
+
+        /**
+         * Returns the address of the peer connected to the socket. This is usually unnamed for client sockets.
+         */
+        abl::LocalAddress getpeername() const;
+
+        /**
+         * Returns the address that the socket is bound too.
+         */
+        abl::LocalAddress getsockname() const;
+
+        /**
+         * Receives bytes into the ByteBuffer. Resizes the buffer to the appropriate size.
+         *
+         * @param buffer The buffer to write too.
+         * @param amount The maximum amount of bytes to read.
+         * @param offset The index in the buffer to start writing at.
+         * @param flags Flags to pass to the system.
+         *
+         * @return The number of bytes read
+         */
+        size_t
+        recv(ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+
+        size_t
+        send(const ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+
+        /**
+         * Sends bytes directly from the caller's memory.
+         *
+         * @return The number of bytes sent
+         */
+        size_t
+        send(const byte* data, size_t amount, int flags = 0) const;
+
+        /**
+         * Sends several buffers with a single system call, in order, without concatenating them first. On a
+         * SEQPACKET socket, the buffers form a single message.
+         *
+         * @return The number of bytes sent.
+         */
+        size_t
+        sendv(const ConstByteView* views, size_t count, int flags = 0) const;
+
+        size_t
+        sendv(std::initializer_list<ConstByteView> views, int flags = 0) const;
+
+        /**
+         * Receives into several buffers with a single system call, filling each buffer before moving on to the next.
+         * The buffers are not resized.
+         *
+         * @return The number of bytes received.
+         */
+        size_t
+        recvv(const ByteView* views, size_t count, int flags = 0) const;
+
+        size_t
+        recvv(std::initializer_list<ByteView> views, int flags = 0) const;
+
+        /** The maximum number of buffers passed to the system by one call to sendv() or recvv() */
+        static const size_t MAX_VECTORS = abl::MAX_STREAM_VECTORS;
+
+        /**
+         * Sends copies of system handles to the peer, for example to hand listening sockets and live connections to
+         * another process (SCM_RIGHTS). The handles stay open in this process.
+         *
+         * At least one byte of data must accompany the handles. The handles are delivered with the first byte.
+         *
+         * @param handles The handles to send. At most MAX_HANDLES are sent.
+         * @param count The number of handles.
+         * @param data The bytes to send along with the handles.
+         * @param flags Flags to pass to the system.
+         * @return The number of bytes sent.
+         */
+        size_t
+        send_handles(const abl::native_handle_t* handles, size_t count, ConstByteView data, int flags = 0) const;
+
+        size_t
+        send_handles(std::initializer_list<std::reference_wrapper<const abl::SocketHandle>> handles,
+                     ConstByteView data, int flags = 0) const;
+
+        /**
+         * Receives bytes like recv(), along with any handles the peer sent with send_handles(). Received handles
+         * are marked close-on-exec.
+         *
+         * @param buffer The buffer to write too.
+         * @param amount The maximum amount of bytes to read.
+         * @param offset The index in the buffer to start writing at.
+         * @param flags Flags to pass to the system.
+         * @return A tuple with the number of bytes read and the received handles. Handles beyond MAX_HANDLES are
+         * closed by the system.
+         */
+        std::tuple<size_t, std::vector<abl::SocketHandle>>
+        recv_handles(ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+
+        /** The maximum number of handles passed by one call to send_handles() or recv_handles() */
+        static const size_t MAX_HANDLES = 64;
+
+        /**
+         * Performs the same function as recv(), but reports a read that would block, and a closed connection, through
+         * the returned status instead of throwing. Intended for sockets in non-blocking mode.
+         *
+         * The buffer is resized to offset + IoResult::bytes.
+         */
+        IoResult
+        try_recv(ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+
+        /**
+         * Performs the same function as send(), but reports a write that would block through the returned status
+         * instead of throwing. Intended for sockets in non-blocking mode.
+         */
+        IoResult
+        try_send(const ByteBuffer& buffer, size_t amount, size_t offset = 0, int flags = 0) const;
+
+        IoResult
+        try_send(const byte* data, size_t amount, int flags = 0) const;
+    };
+
+    using UnixConnection = Connection<UnixStreamSocket>;
+
+    /**
+     * Connects to a local socket and returns a Connection object if successful.
+     *
+     * @param path The path of the socket to connect too.
+     * @param type Either STREAM or SEQPACKET.
+     * @return A connection object representing the connection.
+     */
+    UnixConnection connect_local(const abl::LocalAddress& path, abl::sock_type type = abl::sock_type::STREAM);
+}
@@ -0,0 +1,90 @@
+//
+// Defines a helper that ties the lifetime of buffers to MSG_ZEROCOPY sends.
+//
+
+#pragma once
+
+#include "TCPSocket.h"
+#include "Byte.h"
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+#ifndef DEFAULT_ZEROCOPY_THRESHOLD
+#define DEFAULT_ZEROCOPY_THRESHOLD 10240
+#endif
+
+namespace sockets {
+
+    /**
+     * Sends large buffers from a TCPSocket without copying them into the kernel.
+     *
+     * Every buffer sent with zero-copy is kept alive until the system reports that it no longer needs it. Call
+     * reap() regularly, for example when an EventLoop reports EventLoop::ERROR on the socket, to release buffers.
+     * A buffer can be reused once in_flight() no longer includes it, i.e. once its reference count drops.
+     *
+     * Sends smaller than the threshold are copied as usual, since zero-copy only pays off for large payloads.
+     *
+     * The system numbers the zero-copy sends of a socket, and the sender matches completions to buffers by counting
+     * its own sends. It must therefore be the only source of zero-copy sends on the socket from the moment it is
+     * created: the constructor throws InvalidStateError if zero-copy is already enabled on the socket, and reap()
+     * throws it if the system reports a send the sender did not make. Do not call TCPSocket::send_zerocopy()
+     * directly while a sender exists; a foreign send cannot always be detected, and a buffer may then be released
+     * while the system still reads from it.
+     *
+     * The socket must outlive the sender. This class is only available on Linux.
+     */
+    class ZeroCopySender
+    {
+    protected:
+        TCPSocket& _socket;
+        size_t _threshold;
+        /** Number the system will give to the next zero-copy send */
+        uint32_t _next_id;
+        /** Buffers referenced by zero-copy sends that have not completed, in the order they were sent */
+        std::deque<std::pair<uint32_t, SharedByteBuffer>> _in_flight;
+        bool _copied;
+
+    public:
+        /**
+         * Enables zero-copy on the socket.
+         *
+         * @param socket The socket to send on.
+         * @param threshold The minimum size of a send that uses zero-copy.
+         */
+        explicit ZeroCopySender(TCPSocket& socket, size_t threshold = DEFAULT_ZEROCOPY_THRESHOLD);
+
+        ZeroCopySender(const ZeroCopySender&) = delete;
+        ZeroCopySender& operator=(const ZeroCopySender&) = delete;
+
+        /**
+         * Sends up to amount bytes of the buffer, starting at offset. Like TCPSocket::send(), this may send fewer
+         * bytes than requested.
+         *
+         * @return The number of bytes sent.
+         */
+        size_t
+        send(const SharedByteBuffer& buffer, size_t amount, size_t offset = 0);
+
+        /**
+         * Reads completion notifications without blocking and releases the buffers of completed sends.
+         *
+         * @return The number of sends that completed.
+         */
+        size_t
+        reap();
+
+        /**
+         * Returns the number of zero-copy sends that have not completed.
+         */
+        size_t
+        in_flight() const;
+
+        /**
+         * Returns true if the system reported that it had to copy the data of a completed send, in which case
+         * zero-copy brings no benefit on this socket. This is always the case over loopback.
+         */
+        bool
+        copied() const;
+    };
+}
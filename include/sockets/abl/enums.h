@@ -9,7 +9,9 @@ namespace sockets {
         {
             ANY,
             INET,
-            INET6
+            INET6,
+            /** Local (unix domain) sockets, addressed by a path */
+            LOCAL
         };
 
         /**
@@ -19,7 +21,9 @@ namespace sockets {
         {
             STREAM,
             DATAGRAM,
-            RAW
+            RAW,
+            /** Reliable, connection-based datagrams that preserve message boundaries */
+            SEQPACKET
         };
 
         /**
@@ -28,7 +32,9 @@ namespace sockets {
         enum sock_proto : int
         {
             TCP,
-            UDP
+            UDP,
+            /** The default protocol for the family and type, e.g. for LOCAL sockets */
+            DEFAULT
         };
     }
 }
@@ -6,6 +6,8 @@
 #pragma once
 
 #include "enums.h"
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace sockets {
@@ -27,7 +29,172 @@ namespace sockets {
 
         using HandleRef = const handle_t *;
 
-        UniqueHandle new_unique_handle(ip_family family, sock_type type, sock_proto protocol);
-        SharedHandle new_shared_handle(ip_family family, sock_type type, sock_proto protocol);
+#ifdef _WIN32
+        /** The system socket type. Same as SOCKET, which cannot be named here without including winsock2.h. */
+        using native_handle_t = uintptr_t;
+#else
+        /** The system socket type. */
+        using native_handle_t = int;
+#endif
+
+        /** The value of an invalid system socket. Same as INVALID_SOCKET on Windows and -1 elsewhere. */
+        const native_handle_t INVALID_NATIVE_HANDLE = static_cast<native_handle_t>(-1);
+
+        /**
+         * Closes a system socket.
+         * This function is not intended to be called directly. Use SocketHandle instead.
+         */
+        void close_native_handle(native_handle_t handle);
+
+        /**
+         * Owns a system socket and closes it when destroyed.
+         *
+         * Unlike UniqueHandle, the socket is stored inline, so creating a SocketHandle does not allocate and reading
+         * the system socket does not go through a pointer.
+         */
+        class SocketHandle
+        {
+            native_handle_t _handle;
+
+        public:
+            /**
+             * Creates an invalid handle.
+             */
+            SocketHandle() noexcept : _handle(INVALID_NATIVE_HANDLE) {}
+
+            /**
+             * Takes ownership of a system socket.
+             */
+            explicit SocketHandle(native_handle_t handle) noexcept : _handle(handle) {}
+
+            /**
+             * Takes ownership of the system socket owned by a UniqueHandle.
+             */
+            explicit SocketHandle(UniqueHandle&& handle);
+
+            SocketHandle(const SocketHandle&) = delete;
+            SocketHandle& operator=(const SocketHandle&) = delete;
+
+            SocketHandle(SocketHandle&& other) noexcept : _handle(other.release()) {}
+
+            SocketHandle& operator=(SocketHandle&& other) noexcept
+            {
+                reset(other.release());
+                return *this;
+            }
+
+            ~SocketHandle()
+            {
+                reset();
+            }
+
+            /**
+             * Returns the system socket, or INVALID_NATIVE_HANDLE if this handle is invalid.
+             */
+            native_handle_t get() const noexcept
+            {
+                return _handle;
+            }
+
+            /**
+             * Returns true if this handle owns a system socket.
+             */
+            explicit operator bool() const noexcept
+            {
+                return _handle != INVALID_NATIVE_HANDLE;
+            }
+
+            /**
+             * Gives up ownership of the system socket without closing it.
+             */
+            native_handle_t release() noexcept
+            {
+                native_handle_t rv = _handle;
+                _handle = INVALID_NATIVE_HANDLE;
+                return rv;
+            }
+
+            /**
+             * Closes the owned system socket, if any, and takes ownership of another.
+             */
+            void reset(native_handle_t handle = INVALID_NATIVE_HANDLE) noexcept
+            {
+                if (_handle != INVALID_NATIVE_HANDLE && _handle != handle)
+                    close_native_handle(_handle);
+                _handle = handle;
+            }
+
+            bool operator==(const SocketHandle& other) const noexcept
+            {
+                return _handle == other._handle;
+            }
+
+            bool operator!=(const SocketHandle& other) const noexcept
+            {
+                return _handle != other._handle;
+            }
+        };
+
+        /**
+         * Creates a new system socket.
+         *
+         * @param nonblocking If true, the socket is created in non-blocking mode.
+         */
+        UniqueHandle new_unique_handle(ip_family family, sock_type type, sock_proto protocol, bool nonblocking = false);
+        SharedHandle new_shared_handle(ip_family family, sock_type type, sock_proto protocol, bool nonblocking = false);
+        SocketHandle new_socket_handle(ip_family family, sock_type type, sock_proto protocol, bool nonblocking = false);
+
+        /**
+         * Enables or disables non-blocking mode on a handle.
+         */
+        void set_nonblocking(HandleRef handle, bool nonblocking);
+        void set_nonblocking(const SocketHandle& handle, bool nonblocking);
+
+        /**
+         * Returns true if the handle is in non-blocking mode. Windows cannot report the mode of a socket, so there
+         * this always returns false.
+         */
+        bool is_nonblocking(const SocketHandle& handle);
+
+        /**
+         * The events poll_handles() waits for and reports. FAILED is only reported, and is reported whether it was
+         * requested or not.
+         */
+        namespace poll_event
+        {
+            const int READABLE = 1;
+            const int WRITABLE = 2;
+            const int FAILED = 4;
+        }
+
+        /**
+         * A handle to wait for with poll_handles().
+         */
+        struct PollEntry
+        {
+            const SocketHandle* handle;
+            /** The poll_event values to wait for */
+            int events;
+            /** Set by poll_handles() to the poll_event values that occurred */
+            int ready;
+        };
+
+        /**
+         * Waits until at least one of the handles is ready, or until the timeout expires (poll(), or WSAPoll() on
+         * Windows).
+         *
+         * @param entries The handles to wait for.
+         * @param count The number of handles.
+         * @param timeout_ms The maximum time to wait in milliseconds, or -1 to wait indefinitely.
+         * @return The number of ready handles. 0 if the timeout expired or the wait was interrupted by a signal.
+         */
+        size_t poll_handles(PollEntry* entries, size_t count, int timeout_ms);
+
+        /**
+         * Returns the flag that makes a single send() or recv() non-blocking without changing the mode of the socket
+         * (MSG_DONTWAIT), or 0 on systems without one. On those systems, such as Windows, a send() that follows a
+         * poll_handles() reporting WRITABLE may still block if it is larger than the free space of the socket buffer.
+         */
+        int nonblocking_io_flag();
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,80 @@
+//
+// Defines the address type for local (unix domain) sockets.
+//
+
+#pragma once
+
+#include "enums.h"
+
+#include <string>
+
+namespace sockets {
+    namespace abl {
+        /**
+         * The address of a local socket, which is a filesystem path.
+         *
+         * On Linux, a path starting with a null character names a socket in the abstract namespace, which does not
+         * exist on the filesystem and disappears when the last socket bound to it is closed.
+         */
+        class LocalAddress
+        {
+        private:
+            std::string _path;
+
+        public:
+            /**
+             * Creates an unnamed address.
+             */
+            LocalAddress() = default;
+
+            explicit LocalAddress(std::string path) : _path(std::move(path)) {}
+
+            /**
+             * Creates an address in the Linux abstract namespace.
+             *
+             * @param name The name of the socket, without the leading null character.
+             */
+            static LocalAddress
+            abstract(const std::string &name)
+            {
+                return LocalAddress(std::string(1, '\0') + name);
+            }
+
+            const std::string &
+            path() const
+            {
+                return _path;
+            }
+
+            bool
+            is_abstract() const
+            {
+                return !_path.empty() && _path[0] == '\0';
+            }
+
+            /**
+             * Tests if the address is unnamed, as is the case for connected client sockets that were never bound.
+             */
+            bool
+            is_unnamed() const
+            {
+                return _path.empty();
+            }
+
+            ip_family
+            get_family() const
+            {
+                return ip_family::LOCAL;
+            }
+
+            /**
+             * Returns the textual representation of the address. Abstract addresses are prefixed with '@'.
+             */
+            std::string
+            name() const
+            {
+                return is_abstract() ? "@" + _path.substr(1) : _path;
+            }
+        };
+    }
+}
@@ -0,0 +1,84 @@
+//
+// Defines the I/O operations shared by the connection-oriented socket types.
+//
+
+#pragma once
+
+#include "handle.h"
+#include "system.h"
+#include "sockets/Byte.h"
+#include "sockets/IoResult.h"
+
+namespace sockets {
+    namespace abl {
+        /** The maximum number of buffers passed to the system by one call to stream_sendv() or stream_recvv() */
+        const size_t MAX_STREAM_VECTORS = 64;
+
+        /**
+         * Accepts a connection, creating the new socket close-on-exec and, if requested, non-blocking in the same
+         * system call where the system supports it.
+         *
+         * @param listener The listening socket.
+         * @param addr Receives the address of the peer. May be null.
+         * @param addr_len The size of addr, updated to the size of the address. May be null.
+         * @param nonblocking If true, the new socket is in non-blocking mode.
+         * @return The new socket, or INVALID_NATIVE_HANDLE if the call failed.
+         */
+        native_handle_t
+        accept_handle(const SocketHandle& listener, sockaddr* addr, socklen_t* addr_len, bool nonblocking);
+
+        /**
+         * Receives up to amount bytes into the buffer, starting at offset. The buffer is resized to offset plus the
+         * number of bytes received. Throws SocketReadError, naming function_name as the throwing function.
+         *
+         * @return The number of bytes received.
+         */
+        size_t
+        stream_recv(const SocketHandle& handle, ByteBuffer& buffer, size_t amount, size_t offset, int flags,
+                    const char* function_name);
+
+        /**
+         * Sends up to amount bytes. Throws SocketWriteError, naming function_name as the throwing function.
+         *
+         * @return The number of bytes sent.
+         */
+        size_t
+        stream_send(const SocketHandle& handle, const byte* data, size_t amount, int flags,
+                    const char* function_name);
+
+        /**
+         * Sends several buffers with a single system call. At most MAX_STREAM_VECTORS buffers are sent.
+         * Throws SocketWriteError, naming function_name as the throwing function.
+         *
+         * @return The number of bytes sent.
+         */
+        size_t
+        stream_sendv(const SocketHandle& handle, const ConstByteView* views, size_t count, int flags,
+                     const char* function_name);
+
+        /**
+         * Receives into several buffers with a single system call. At most MAX_STREAM_VECTORS buffers are filled.
+         * Throws SocketReadError, naming function_name as the throwing function.
+         *
+         * @return The number of bytes received.
+         */
+        size_t
+        stream_recvv(const SocketHandle& handle, const ByteView* views, size_t count, int flags,
+                     const char* function_name);
+
+        /**
+         * Receives bytes, reporting a read that would block and a closed connection through the returned status.
+         * The buffer is resized to offset + IoResult::bytes.
+         */
+        IoResult
+        stream_try_recv(const SocketHandle& handle, ByteBuffer& buffer, size_t amount, size_t offset, int flags,
+                        const char* function_name);
+
+        /**
+         * Sends bytes, reporting a write that would block through the returned status.
+         */
+        IoResult
+        stream_try_send(const SocketHandle& handle, const byte* data, size_t amount, int flags,
+                        const char* function_name);
+    }
+}
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "ip.h"
+#include "local.h"
 #include "handle.h"
 #include "enums.h"
 
@@ -23,6 +24,7 @@ using socklen_t = int;
 
 #endif
 
+#include <stdexcept>
 #include <string>
 
 namespace sockets {
@@ -48,6 +50,20 @@ namespace sockets {
             SharedHandle
             shared_from_system_handle(SOCKET handle);
 
+            inline SOCKET
+            get_system_handle(const SocketHandle &handle)
+            {
+                if(handle)
+                    return static_cast<SOCKET>(handle.get());
+                throw std::invalid_argument("handle is invalid");
+            }
+
+            inline SocketHandle
+            socket_from_system_handle(SOCKET handle)
+            {
+                return SocketHandle(static_cast<native_handle_t>(handle));
+            }
+
 #elif __unix
             int get_system_handle(const handle_t* handle);
             int get_system_handle(const UniqueHandle& handle);
@@ -60,6 +76,33 @@ namespace sockets {
 
             SharedHandle
             shared_from_system_handle(int handle);
+
+            inline int get_system_handle(const SocketHandle& handle)
+            {
+                if(handle)
+                    return handle.get();
+                throw std::invalid_argument("handle is invalid");
+            }
+
+            inline SocketHandle
+            socket_from_system_handle(int handle)
+            {
+                return SocketHandle(handle);
+            }
+
+            /**
+             * Writes a LocalAddress into a sockaddr_storage as a sockaddr_un.
+             *
+             * @return The length of the written address.
+             */
+            socklen_t
+            from_localaddress(const LocalAddress &address, sockaddr_storage &storage);
+
+            /**
+             * Reads a LocalAddress from a sockaddr_un of the given length.
+             */
+            LocalAddress
+            to_localaddress(const sockaddr_storage &storage, socklen_t length);
 #endif
 
             /**
@@ -104,6 +147,14 @@ namespace sockets {
             IpAddress
             to_ipaddress(const sockaddr *addr);
 
+            /**
+             * Writes an IpAddress into a sockaddr_storage.
+             *
+             * @return The length of the written address, or 0 if the address is neither ipv4 nor ipv6.
+             */
+            socklen_t
+            from_ipaddress(const IpAddress &address, sockaddr_storage &storage);
+
             /**
              * Creates a sockaddr_in object from a string and a port.
              *
@@ -7,6 +7,8 @@
 #include "Byte.h"
 #include <type_traits>
 #include <cstddef>
+#include <iterator>
+#include <string>
 
 namespace sockets {
     /**
@@ -43,6 +45,43 @@ namespace sockets {
         static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
     };
 
+    /**
+     * Tests if T implements ::set_cork(bool)
+     * @tparam T
+     */
+    template<typename T>
+    struct has_set_cork
+    {
+    private:
+        template<typename U>
+        static auto test(size_t) -> decltype(std::declval<U>().set_cork(true), std::true_type());
+
+        template<typename>
+        static std::false_type test(...);
+    public:
+
+        static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+    };
+
+    /**
+     * Tests if T exposes its system socket as a member named handle, so a Connection can wait on it with a deadline.
+     * @tparam T
+     */
+    template<typename T>
+    struct has_socket_handle
+    {
+    private:
+        template<typename U>
+        static auto test(size_t) -> decltype(std::declval<U>().handle.get(), std::true_type());
+
+        template<typename>
+        static std::false_type test(...);
+
+    public:
+
+        static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+    };
+
     template<typename T>
     struct can_be_invalid
     {
@@ -57,4 +96,45 @@ namespace sockets {
 
         static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
     };
+
+    /**
+     * Tests if Iter points into contiguous memory holding byte-sized values. A range of such iterators can be passed
+     * to the system as a pointer and a length, without copying.
+     * @tparam Iter
+     */
+    template<typename Iter>
+    struct is_contiguous_byte_iterator
+    {
+    private:
+        using value_type = typename std::remove_cv<typename std::iterator_traits<Iter>::value_type>::type;
+
+        static constexpr bool is_byte_sized = sizeof(value_type) == 1 &&
+                                              std::is_integral<value_type>::value &&
+                                              !std::is_same<value_type, bool>::value;
+
+        static constexpr bool is_contiguous = std::is_pointer<Iter>::value ||
+                                              std::is_same<Iter, ByteBuffer::iterator>::value ||
+                                              std::is_same<Iter, ByteBuffer::const_iterator>::value ||
+                                              std::is_same<Iter, std::vector<char>::iterator>::value ||
+                                              std::is_same<Iter, std::vector<char>::const_iterator>::value ||
+                                              std::is_same<Iter, std::string::iterator>::value ||
+                                              std::is_same<Iter, std::string::const_iterator>::value;
+    public:
+
+        static constexpr bool value = is_byte_sized && is_contiguous;
+    };
+
+    /**
+     * Tests if every type in Ts can be converted to a ConstByteView.
+     * @tparam Ts
+     */
+    template<typename... Ts>
+    struct are_byte_views : std::true_type {};
+
+    template<typename T, typename... Ts>
+    struct are_byte_views<T, Ts...>
+    {
+        static constexpr bool value = std::is_convertible<const T&, ConstByteView>::value &&
+                                      are_byte_views<Ts...>::value;
+    };
 }
\ No newline at end of file
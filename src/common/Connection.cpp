@@ -4,30 +4,198 @@
 
 #include <sockets/abl/ip.h>
 #include <sockets/Connection.h>
+#include <sockets/Error.h>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <vector>
 
 using sockets::abl::AddrInfoFlags;
+using sockets::abl::address_info;
 using sockets::abl::ip_family;
 using sockets::abl::sock_type;
 using sockets::abl::sock_proto;
 
 namespace sockets
 {
+    namespace
+    {
+        /** The time to wait for a connection attempt before starting the next one, as recommended by RFC 8305 */
+        const std::chrono::milliseconds CONNECTION_ATTEMPT_DELAY(250);
+
+        using clock = std::chrono::steady_clock;
+
+        /**
+         * Returns the poll timeout in milliseconds until the earlier of two points in time, or -1 if both are
+         * clock::time_point::max().
+         */
+        int poll_timeout(clock::time_point a, clock::time_point b)
+        {
+            auto until = std::min(a, b);
+            if (until == clock::time_point::max())
+                return -1;
+
+            // Round up, so a wait for less than a millisecond does not return at once and spin
+            using rep = std::chrono::milliseconds::rep;
+            auto remaining_time = until - clock::now() + std::chrono::milliseconds(1) - std::chrono::nanoseconds(1);
+            rep remaining = std::chrono::duration_cast<std::chrono::milliseconds>(remaining_time).count();
+            return static_cast<int>(std::min<rep>(std::max<rep>(remaining, 0), std::numeric_limits<int>::max()));
+        }
+
+        std::vector<address_info> resolve(const std::string& host, const std::string& port)
+        {
+            AddrInfoFlags flags = AddrInfoFlags();
+            flags.set_ipv4_mapping().set_addr_config();
+
+            auto addresses = get_address_info(host,
+                    port,
+                    flags,
+                    ip_family::ANY,
+                    sock_type::STREAM,
+                    sock_proto::TCP);
+
+            if (addresses.empty())
+                throw InvalidStateError("sockets", "connect_to", "get_address_info returned no addresses for " + host + "!");
+
+            return addresses;
+        }
+
+        /**
+         * Reorders the addresses so the families alternate, starting with the family of the first address. The
+         * system already sorts the addresses by preference.
+         */
+        std::vector<address_info> interleave_families(std::vector<address_info> addresses)
+        {
+            ip_family first = addresses[0].family;
+            auto second_begin = std::stable_partition(addresses.begin(), addresses.end(),
+                                                      [first](const address_info& info) { return info.family == first; });
+
+            std::vector<address_info> rv;
+            rv.reserve(addresses.size());
+
+            auto a = addresses.begin();
+            auto b = second_begin;
+            while (a != second_begin || b != addresses.end())
+            {
+                if (a != second_begin)
+                    rv.push_back(*a++);
+                if (b != addresses.end())
+                    rv.push_back(*b++);
+            }
+
+            return rv;
+        }
+
+        /**
+         * Connects to the first address that accepts the connection, following Happy Eyeballs (RFC 8305). A new
+         * non-blocking attempt is started whenever the previous one has not completed within
+         * CONNECTION_ATTEMPT_DELAY, or as soon as it fails. Attempts that are still pending when one succeeds are
+         * closed. Throws ConnectError with type TIMED_OUT if no attempt succeeds before the deadline.
+         */
+        TCPSocket race_connect(const std::vector<address_info>& resolved,
+                               clock::time_point deadline = clock::time_point::max())
+        {
+            auto addresses = interleave_families(resolved);
+            size_t next = 0;
+            int last_error = 0;
+
+            std::vector<TCPSocket> attempts;
+            auto next_start = clock::now();
+
+            while (next < addresses.size() || !attempts.empty())
+            {
+                // Checked first, so no attempt starts once the deadline has passed
+                if (clock::now() >= deadline)
+                    throw ConnectError("connect_to", get_timed_out_code());
+
+                if (next < addresses.size() && (attempts.empty() || clock::now() >= next_start))
+                {
+                    try
+                    {
+                        TCPSocket s(addresses[next].family, true);
+                        if (s.start_connect(addresses[next].address))
+                        {
+                            s.set_nonblocking(false);
+                            return s;
+                        }
+                        attempts.push_back(std::move(s));
+                        next_start = clock::now() + CONNECTION_ATTEMPT_DELAY;
+                    }
+                    catch (MethodError& e)
+                    {
+                        // The attempt failed at once, so there is nothing to wait for before the next one
+                        last_error = e.error_code;
+                        next_start = clock::now();
+                    }
+
+                    ++next;
+                    continue;
+                }
+
+                auto start_at = next < addresses.size() ? next_start : clock::time_point::max();
+                int timeout_ms = poll_timeout(start_at, deadline);
+
+                std::vector<abl::PollEntry> entries;
+                for (auto& attempt : attempts)
+                    entries.push_back(abl::PollEntry{&attempt.handle, abl::poll_event::WRITABLE, 0});
+
+                if (abl::poll_handles(entries.data(), entries.size(), timeout_ms) == 0)
+                    continue;
+
+                // Walk backwards so failed attempts can be erased without disturbing the remaining indices
+                for (size_t i = entries.size(); i-- > 0;)
+                {
+                    if (entries[i].ready == 0)
+                        continue;
+
+                    int error = attempts[i].take_error();
+                    if (error == 0)
+                    {
+                        attempts[i].set_nonblocking(false);
+                        return std::move(attempts[i]);
+                    }
+
+                    last_error = error;
+                    attempts.erase(attempts.begin() + i);
+                    next_start = clock::now();
+                }
+            }
+
+            throw ConnectError("connect_to", last_error);
+        }
+    }
+
     TCPConnection connect_to(std::string host, std::string port)
     {
-        AddrInfoFlags flags = AddrInfoFlags();
-        flags.set_ipv4_mapping().set_addr_config();
+        return TCPConnection(race_connect(resolve(host, port)));
+    }
+
+    TCPConnection connect_to(std::string host, std::string port, std::chrono::milliseconds timeout)
+    {
+        auto deadline = clock::now() + timeout;
+        return TCPConnection(race_connect(resolve(host, port), deadline));
+    }
+
+    TCPConnection connect_to(std::string host, std::string port, ConstByteView initial_data)
+    {
+        auto addresses = resolve(host, port);
 
-        auto addresses = get_address_info(host,
-                port,
-                flags,
-                ip_family::ANY,
-                sock_type::STREAM,
-                sock_proto::TCP);
+        // Fast Open starts the connection with the first send, so it cannot be raced across several addresses
+        if (addresses.size() > 1)
+        {
+            TCPSocket s = race_connect(addresses);
+            size_t sent = 0;
+            while (sent < initial_data.size)
+                sent += s.send(initial_data.data + sent, initial_data.size - sent);
 
+            return TCPConnection(std::move(s));
+        }
 
         TCPSocket s(addresses[0].family);
-        s.connect(addresses[0].address);
+        size_t sent = s.connect_send(addresses[0].address, initial_data.data, initial_data.size);
+        while (sent < initial_data.size)
+            sent += s.send(initial_data.data + sent, initial_data.size - sent);
 
         return TCPConnection(std::move(s));
     }
-}
\ No newline at end of file
+}
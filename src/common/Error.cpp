@@ -38,6 +38,17 @@ namespace sockets {
         return ss.str();
     }
 
+    MessageTooLargeError::MessageTooLargeError(std::string tfn, size_t limit) :
+    throwing_function_name(std::move(tfn)), limit(limit) {}
+
+    std::string MessageTooLargeError::string(std::stringstream ss) const
+    {
+        ss << "MessageTooLargeError thrown by " << throwing_function_name << ": ";
+        ss << "the message is longer than " << limit << " bytes.";
+
+        return ss.str();
+    }
+
     InvalidStateError::InvalidStateError(std::string class_name, std::string function_name, std::string message) :
     class_name(std::move(class_name)), function_name(std::move(function_name)), message(std::move(message)) {}
 
@@ -57,8 +68,8 @@ namespace sockets {
         return ss.str();
     }
 
-    SocketReadError::SocketReadError(std::string tfn) : MethodError(std::move(tfn), "recv"),
-                                                        type(map_error_type(get_error_code()))
+    SocketReadError::SocketReadError(std::string tfn, int ec) : MethodError(std::move(tfn), "recv", ec),
+                                                                type(map_error_type(ec))
     {
     }
 
@@ -73,8 +84,25 @@ namespace sockets {
         return ss.str();
     }
 
-    SocketWriteError::SocketWriteError(std::string tfn) : MethodError(std::move(tfn), "send"),
-                                                          type(map_error_type(get_error_code()))
+    ConnectError::ConnectError(std::string tfn, int ec) : MethodError(std::move(tfn), "connect", ec),
+                                                          type(map_error_type(ec))
+    {
+    }
+
+    std::string ConnectError::string(std::stringstream ss) const
+    {
+        ss << "ConnectError thrown by " << throwing_function_name;
+        ss << (type == TIMED_OUT ? " (timed out). " : ". ");
+        ss << "Error code: " << error_code;
+
+        if(lookup)
+            ss << ": " << lookup(error_code);
+
+        return ss.str();
+    }
+
+    SocketWriteError::SocketWriteError(std::string tfn, int ec) : MethodError(std::move(tfn), "send", ec),
+                                                                  type(map_error_type(ec))
     {
     }
 
@@ -0,0 +1,351 @@
+//
+// Implementation of the typed socket options of TCPSocket.
+//
+
+#include <sockets/abl/system.h>
+#include <sockets/TCPSocket.h>
+#include <sockets/Error.h>
+#include <string>
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#include <mstcpip.h>
+#else
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define SOCKET_ERROR -1
+#endif
+
+namespace sockets
+{
+    using namespace abl;
+
+    namespace
+    {
+        template<typename Option>
+        struct bool_option
+        {
+            using system_type = int;
+            static system_type to_system(const Option& option) { return option.value ? 1 : 0; }
+            static Option from_system(system_type value) { return Option{value != 0}; }
+        };
+
+        template<typename Option>
+        struct int_option
+        {
+            using system_type = int;
+            static system_type to_system(const Option& option) { return option.value; }
+            static Option from_system(system_type value) { return Option{value}; }
+        };
+
+        template<typename Option, typename Duration>
+        struct duration_option
+        {
+            using system_type = int;
+            static system_type to_system(const Option& option) { return static_cast<int>(option.value.count()); }
+            static Option from_system(system_type value) { return Option{Duration(value)}; }
+        };
+
+        /**
+         * Maps an option type onto the arguments of setsockopt(). locate() returns false if the system does not
+         * support the option.
+         */
+        template<typename Option>
+        struct option_traits;
+
+        template<>
+        struct option_traits<options::NoDelay> : bool_option<options::NoDelay>
+        {
+            static constexpr const char* name = "TCP_NODELAY";
+            static bool locate(int& level, int& id) { level = IPPROTO_TCP; id = TCP_NODELAY; return true; }
+        };
+
+        template<>
+        struct option_traits<options::SendBuffer> : int_option<options::SendBuffer>
+        {
+            static constexpr const char* name = "SO_SNDBUF";
+            static bool locate(int& level, int& id) { level = SOL_SOCKET; id = SO_SNDBUF; return true; }
+        };
+
+        template<>
+        struct option_traits<options::ReceiveBuffer> : int_option<options::ReceiveBuffer>
+        {
+            static constexpr const char* name = "SO_RCVBUF";
+            static bool locate(int& level, int& id) { level = SOL_SOCKET; id = SO_RCVBUF; return true; }
+        };
+
+        template<>
+        struct option_traits<options::KeepAlive> : bool_option<options::KeepAlive>
+        {
+            static constexpr const char* name = "SO_KEEPALIVE";
+            static bool locate(int& level, int& id) { level = SOL_SOCKET; id = SO_KEEPALIVE; return true; }
+        };
+
+        template<>
+        struct option_traits<options::KeepIdle> : duration_option<options::KeepIdle, std::chrono::seconds>
+        {
+            static constexpr const char* name = "TCP_KEEPIDLE";
+            static bool locate(int& level, int& id)
+            {
+#if defined(TCP_KEEPIDLE)
+                level = IPPROTO_TCP; id = TCP_KEEPIDLE; return true;
+#elif defined(TCP_KEEPALIVE)
+                level = IPPROTO_TCP; id = TCP_KEEPALIVE; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+        };
+
+        template<>
+        struct option_traits<options::KeepInterval> : duration_option<options::KeepInterval, std::chrono::seconds>
+        {
+            static constexpr const char* name = "TCP_KEEPINTVL";
+            static bool locate(int& level, int& id)
+            {
+#ifdef TCP_KEEPINTVL
+                level = IPPROTO_TCP; id = TCP_KEEPINTVL; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+        };
+
+        template<>
+        struct option_traits<options::KeepCount> : int_option<options::KeepCount>
+        {
+            static constexpr const char* name = "TCP_KEEPCNT";
+            static bool locate(int& level, int& id)
+            {
+#ifdef TCP_KEEPCNT
+                level = IPPROTO_TCP; id = TCP_KEEPCNT; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+        };
+
+        template<>
+        struct option_traits<options::QuickAck> : bool_option<options::QuickAck>
+        {
+            static constexpr const char* name = "TCP_QUICKACK";
+            static bool locate(int& level, int& id)
+            {
+#ifdef TCP_QUICKACK
+                level = IPPROTO_TCP; id = TCP_QUICKACK; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+        };
+
+        template<>
+        struct option_traits<options::BusyPoll> : duration_option<options::BusyPoll, std::chrono::microseconds>
+        {
+            static constexpr const char* name = "SO_BUSY_POLL";
+            static bool locate(int& level, int& id)
+            {
+#ifdef SO_BUSY_POLL
+                level = SOL_SOCKET; id = SO_BUSY_POLL; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+        };
+
+        template<>
+        struct option_traits<options::NotSentLowat> : int_option<options::NotSentLowat>
+        {
+            static constexpr const char* name = "TCP_NOTSENT_LOWAT";
+            static bool locate(int& level, int& id)
+            {
+#ifdef TCP_NOTSENT_LOWAT
+                level = IPPROTO_TCP; id = TCP_NOTSENT_LOWAT; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+        };
+
+        template<>
+        struct option_traits<options::UserTimeout>
+                : duration_option<options::UserTimeout, std::chrono::milliseconds>
+        {
+            static constexpr const char* name = "TCP_USER_TIMEOUT";
+            static bool locate(int& level, int& id)
+            {
+#ifdef TCP_USER_TIMEOUT
+                level = IPPROTO_TCP; id = TCP_USER_TIMEOUT; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+        };
+
+        template<>
+        struct option_traits<options::Cork> : bool_option<options::Cork>
+        {
+            static constexpr const char* name = "TCP_CORK";
+            static bool locate(int& level, int& id)
+            {
+#if defined(TCP_CORK)
+                level = IPPROTO_TCP; id = TCP_CORK; return true;
+#elif defined(TCP_NOPUSH)
+                level = IPPROTO_TCP; id = TCP_NOPUSH; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+        };
+
+        template<>
+        struct option_traits<options::FastOpen>
+        {
+            using system_type = int;
+            static constexpr const char* name = "TCP_FASTOPEN";
+            static bool locate(int& level, int& id)
+            {
+#ifdef TCP_FASTOPEN
+                level = IPPROTO_TCP; id = TCP_FASTOPEN; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+
+            static system_type to_system(const options::FastOpen& option) { return option.queue_length; }
+            static options::FastOpen from_system(system_type value) { return options::FastOpen{value}; }
+        };
+
+        template<>
+        struct option_traits<options::FastOpenConnect> : bool_option<options::FastOpenConnect>
+        {
+            static constexpr const char* name = "TCP_FASTOPEN_CONNECT";
+            static bool locate(int& level, int& id)
+            {
+#ifdef TCP_FASTOPEN_CONNECT
+                level = IPPROTO_TCP; id = TCP_FASTOPEN_CONNECT; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+        };
+
+        template<>
+        struct option_traits<options::ReuseAddress> : bool_option<options::ReuseAddress>
+        {
+            static constexpr const char* name = "SO_REUSEADDR";
+            static bool locate(int& level, int& id) { level = SOL_SOCKET; id = SO_REUSEADDR; return true; }
+        };
+
+        template<>
+        struct option_traits<options::ReusePort> : bool_option<options::ReusePort>
+        {
+            static constexpr const char* name = "SO_REUSEPORT";
+            static bool locate(int& level, int& id)
+            {
+#ifdef SO_REUSEPORT
+                level = SOL_SOCKET; id = SO_REUSEPORT; return true;
+#else
+                (void) level; (void) id; return false;
+#endif
+            }
+        };
+
+        template<>
+        struct option_traits<options::Linger>
+        {
+            using system_type = linger;
+            static constexpr const char* name = "SO_LINGER";
+            static bool locate(int& level, int& id) { level = SOL_SOCKET; id = SO_LINGER; return true; }
+
+            static system_type to_system(const options::Linger& option)
+            {
+                system_type rv{};
+                rv.l_onoff = option.enabled ? 1 : 0;
+                rv.l_linger = static_cast<decltype(rv.l_linger)>(option.timeout.count());
+                return rv;
+            }
+
+            static options::Linger from_system(const system_type& value)
+            {
+                return options::Linger{value.l_onoff != 0, std::chrono::seconds(value.l_linger)};
+            }
+        };
+
+        template<typename Option>
+        void locate_option(const char* function_name, int& level, int& id)
+        {
+            if (!option_traits<Option>::locate(level, id))
+                throw InvalidStateError("TCPSocket", function_name,
+                                        std::string(option_traits<Option>::name) + " is not supported on this system");
+        }
+    }
+
+    template<typename Option>
+    typename std::enable_if<options::is_tcp_option<Option>::value>::type
+    TCPSocket::set_option(const Option& option)
+    {
+        int level, id;
+        locate_option<Option>(__func__, level, id);
+
+        auto value = option_traits<Option>::to_system(option);
+        auto result = ::setsockopt(system::get_system_handle(this->handle), level, id,
+                                   reinterpret_cast<const char*>(&value), sizeof(value));
+        if (result == SOCKET_ERROR)
+            throw MethodError("TCPSocket::set_option", "setsockopt");
+    }
+
+    template<typename Option>
+    typename std::enable_if<options::is_tcp_option<Option>::value, Option>::type
+    TCPSocket::get_option() const
+    {
+        int level, id;
+        locate_option<Option>(__func__, level, id);
+
+        typename option_traits<Option>::system_type value{};
+        socklen_t length = sizeof(value);
+        auto result = ::getsockopt(system::get_system_handle(this->handle), level, id,
+                                   reinterpret_cast<char*>(&value), &length);
+        if (result == SOCKET_ERROR)
+            throw MethodError("TCPSocket::get_option", "getsockopt");
+
+        return option_traits<Option>::from_system(value);
+    }
+
+    template void TCPSocket::set_option<options::NoDelay>(const options::NoDelay&);
+    template void TCPSocket::set_option<options::SendBuffer>(const options::SendBuffer&);
+    template void TCPSocket::set_option<options::ReceiveBuffer>(const options::ReceiveBuffer&);
+    template void TCPSocket::set_option<options::KeepAlive>(const options::KeepAlive&);
+    template void TCPSocket::set_option<options::KeepIdle>(const options::KeepIdle&);
+    template void TCPSocket::set_option<options::KeepInterval>(const options::KeepInterval&);
+    template void TCPSocket::set_option<options::KeepCount>(const options::KeepCount&);
+    template void TCPSocket::set_option<options::QuickAck>(const options::QuickAck&);
+    template void TCPSocket::set_option<options::BusyPoll>(const options::BusyPoll&);
+    template void TCPSocket::set_option<options::NotSentLowat>(const options::NotSentLowat&);
+    template void TCPSocket::set_option<options::Linger>(const options::Linger&);
+    template void TCPSocket::set_option<options::UserTimeout>(const options::UserTimeout&);
+    template void TCPSocket::set_option<options::Cork>(const options::Cork&);
+    template void TCPSocket::set_option<options::FastOpen>(const options::FastOpen&);
+    template void TCPSocket::set_option<options::FastOpenConnect>(const options::FastOpenConnect&);
+    template void TCPSocket::set_option<options::ReuseAddress>(const options::ReuseAddress&);
+    template void TCPSocket::set_option<options::ReusePort>(const options::ReusePort&);
+
+    template options::NoDelay TCPSocket::get_option<options::NoDelay>() const;
+    template options::SendBuffer TCPSocket::get_option<options::SendBuffer>() const;
+    template options::ReceiveBuffer TCPSocket::get_option<options::ReceiveBuffer>() const;
+    template options::KeepAlive TCPSocket::get_option<options::KeepAlive>() const;
+    template options::KeepIdle TCPSocket::get_option<options::KeepIdle>() const;
+    template options::KeepInterval TCPSocket::get_option<options::KeepInterval>() const;
+    template options::KeepCount TCPSocket::get_option<options::KeepCount>() const;
+    template options::QuickAck TCPSocket::get_option<options::QuickAck>() const;
+    template options::BusyPoll TCPSocket::get_option<options::BusyPoll>() const;
+    template options::NotSentLowat TCPSocket::get_option<options::NotSentLowat>() const;
+    template options::Linger TCPSocket::get_option<options::Linger>() const;
+    template options::UserTimeout TCPSocket::get_option<options::UserTimeout>() const;
+    template options::Cork TCPSocket::get_option<options::Cork>() const;
+    template options::FastOpen TCPSocket::get_option<options::FastOpen>() const;
+    template options::FastOpenConnect TCPSocket::get_option<options::FastOpenConnect>() const;
+    template options::ReuseAddress TCPSocket::get_option<options::ReuseAddress>() const;
+    template options::ReusePort TCPSocket::get_option<options::ReusePort>() const;
+}
@@ -6,36 +6,65 @@
 #include <sockets/Error.h>
 
 namespace sockets {
-    TCPServerSocket::TCPServerSocket(const abl::IpAddress &addr, int backlog) : _serverSocket(addr.get_family())
+    namespace
     {
-        _serverSocket.bind(addr);
-        _serverSocket.listen(backlog);
+        abl::IpAddress resolve_listen_address(const std::string &ip, const std::string &port)
+        {
+            abl::AddrInfoFlags flags = abl::AddrInfoFlags();
+            flags.set_ipv4_mapping().set_passive();
+
+            auto addresses = abl::get_address_info(
+                    ip,
+                    port,
+                    flags,
+                    abl::ip_family::ANY,
+                    abl::sock_type::STREAM,
+                    abl::sock_proto::TCP);
+
+            if (addresses.empty())
+                throw InvalidStateError("TCPServerSocket", __func__, "get_address_info returned no addresses for " + ip + "!");
+
+            return addresses[0].address;
+        }
     }
 
-    TCPServerSocket::TCPServerSocket(const std::string &ip, const std::string& port, int backlog)
+    TCPServerSocket::TCPServerSocket(const abl::IpAddress &addr, int backlog) :
+    TCPServerSocket(addr, ListenOptions{backlog}) {}
+
+    TCPServerSocket::TCPServerSocket(const std::string &ip, const std::string& port, int backlog) :
+    TCPServerSocket(resolve_listen_address(ip, port), ListenOptions{backlog}) {}
+
+    TCPServerSocket::TCPServerSocket(const abl::IpAddress &addr, const ListenOptions& options) :
+    _serverSocket(addr.get_family())
     {
-        abl::AddrInfoFlags flags = abl::AddrInfoFlags();
-        flags.set_ipv4_mapping().set_passive();
+        if (options.reuse_address)
+            _serverSocket.set_reuse_address(true);
+        if (options.reuse_port)
+            _serverSocket.set_reuse_port(true);
+        if (options.fastopen_queue > 0)
+            _serverSocket.set_option(options::FastOpen{options.fastopen_queue});
+
+        _serverSocket.bind(addr);
+        _serverSocket.listen(options.backlog);
+    }
 
-        auto addresses = abl::get_address_info(
-                ip,
-                port,
-                flags,
-                abl::ip_family::ANY,
-                abl::sock_type::STREAM,
-                abl::sock_proto::TCP);
+    TCPServerSocket::TCPServerSocket(const std::string &ip, const std::string& port, const ListenOptions& options) :
+    TCPServerSocket(resolve_listen_address(ip, port), options) {}
 
-        if (addresses.empty())
-            throw InvalidStateError("TCPServerSocket", __func__, "get_address_info returned no addresses for " + ip + "!");
+    TCPServerSocket::TCPServerSocket(TCPSocket&& listening) : _serverSocket(std::move(listening))
+    {
+    }
 
-        _serverSocket = TCPSocket(addresses[0].family);
-        _serverSocket.bind(addresses[0].address);
-        _serverSocket.listen(backlog);
+    TCPSocket TCPServerSocket::apply_accepted_options(TCPSocket&& socket) const
+    {
+        for (auto& apply : _accepted_options)
+            apply(socket);
+        return std::move(socket);
     }
 
     TCPConnection TCPServerSocket::accept() const
     {
-        return TCPConnection(_serverSocket.accept());
+        return TCPConnection(apply_accepted_options(_serverSocket.accept()));
     }
 
     std::tuple<TCPConnection, abl::IpAddress> TCPServerSocket::acceptfrom() const
@@ -44,6 +73,55 @@ namespace sockets {
         abl::IpAddress addr;
         std::tie(peer, addr) = _serverSocket.acceptfrom();
 
-        return std::make_tuple(TCPConnection(std::move(peer)), addr);
+        return std::make_tuple(TCPConnection(apply_accepted_options(std::move(peer))), addr);
+    }
+
+    std::vector<std::tuple<TCPConnection, abl::IpAddress>>
+    TCPServerSocket::accept_batch(size_t max, bool nonblocking) const
+    {
+        auto sockets = _serverSocket.accept_batch(max, nonblocking);
+
+        std::vector<std::tuple<TCPConnection, abl::IpAddress>> accepted;
+        accepted.reserve(sockets.size());
+        for (auto& socket : sockets)
+            accepted.emplace_back(TCPConnection(apply_accepted_options(std::move(std::get<0>(socket)))),
+                                  std::get<1>(socket));
+
+        return accepted;
+    }
+
+    void TCPServerSocket::set_nonblocking(bool nonblocking)
+    {
+        _serverSocket.set_nonblocking(nonblocking);
+    }
+
+    const TCPSocket& TCPServerSocket::get_socket() const
+    {
+        return _serverSocket;
+    }
+
+    std::vector<TCPServerSocket> TCPServerSocket::open_group(const abl::IpAddress &addr, size_t count,
+                                                             ListenOptions options)
+    {
+        options.reuse_port = true;
+
+        std::vector<TCPServerSocket> group;
+        group.reserve(count);
+
+        abl::IpAddress bound = addr;
+        for (size_t i = 0; i < count; ++i)
+        {
+            group.emplace_back(bound, options);
+            // Bind the remaining listeners to the port chosen by the system for the first one.
+            if (i == 0) bound = group[0].get_socket().getsockname();
+        }
+
+        return group;
+    }
+
+    std::vector<TCPServerSocket> TCPServerSocket::open_group(const std::string &ip, const std::string &port,
+                                                             size_t count, ListenOptions options)
+    {
+        return open_group(resolve_listen_address(ip, port), count, options);
     }
 }
\ No newline at end of file
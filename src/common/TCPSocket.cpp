@@ -4,11 +4,16 @@
 
 #include <sockets/abl/system.h>
 #include <sockets/abl/enums.h>
+#include <sockets/abl/stream.h>
 #include <sockets/TCPSocket.h>
 #include <sockets/Error.h>
+#include <algorithm>
+#include <limits>
 
 #ifdef unix
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/uio.h>
 
 #define SOCKET_ERROR -1
 #endif
@@ -17,11 +22,16 @@ namespace sockets
 {
     using namespace abl;
 
-    TCPSocket::TCPSocket() : handle(nullptr, &abl::close_handle) {}
+    const size_t TCPSocket::MAX_VECTORS;
+
+    TCPSocket::TCPSocket() : handle() {}
+
+    TCPSocket::TCPSocket(abl::SocketHandle&& handle) : handle(std::move(handle)) {}
 
     TCPSocket::TCPSocket(abl::UniqueHandle&& handle) : handle(std::move(handle)) {}
 
-    TCPSocket::TCPSocket(abl::ip_family fam) : handle(abl::new_unique_handle(fam, sock_type::STREAM, sock_proto::TCP)) {}
+    TCPSocket::TCPSocket(abl::ip_family fam, bool nonblocking) :
+    handle(abl::new_socket_handle(fam, sock_type::STREAM, sock_proto::TCP, nonblocking)) {}
 
     bool TCPSocket::operator==(sockets::TCPSocket &other)
     {
@@ -30,32 +40,84 @@ namespace sockets
 
     bool TCPSocket::invalid() const
     {
-        return this->handle == nullptr;
+        return !this->handle;
     }
 
-    TCPSocket TCPSocket::accept() const
+    void TCPSocket::set_nonblocking(bool nonblocking)
     {
-        ssize_t result = ::accept(system::get_system_handle(this->handle), nullptr, nullptr);
-        if (result == SOCKET_ERROR)
-            throw MethodError("TCPSocket::accept", "accept");
-        return TCPSocket(system::unique_from_system_handle(static_cast<int>(result)));
+        abl::set_nonblocking(this->handle, nonblocking);
     }
 
-    std::tuple<TCPSocket, IpAddress> TCPSocket::acceptfrom() const
+    void TCPSocket::set_cork(bool cork)
     {
-        std::unique_ptr<sockaddr_storage> addr_ptr = std::make_unique<sockaddr_storage>();
-        socklen_t addr_len = sizeof(sockaddr_storage);
+#if defined(TCP_CORK) || defined(TCP_NOPUSH)
+        set_option(options::Cork{cork});
+#else
+        (void) cork;
+#endif
+    }
 
-        ssize_t result = ::accept(system::get_system_handle(this->handle),
-                               reinterpret_cast<sockaddr*>(addr_ptr.get()),
-                               &addr_len);
-        if (result == SOCKET_ERROR)
+    void TCPSocket::set_reuse_address(bool reuse)
+    {
+        set_option(options::ReuseAddress{reuse});
+    }
+
+    void TCPSocket::set_reuse_port(bool reuse)
+    {
+        set_option(options::ReusePort{reuse});
+    }
+
+    TCPSocket TCPSocket::accept(bool nonblocking) const
+    {
+        auto result = accept_handle(this->handle, nullptr, nullptr, nonblocking);
+        if (result == INVALID_NATIVE_HANDLE)
             throw MethodError("TCPSocket::accept", "accept");
+        return TCPSocket(system::socket_from_system_handle(result));
+    }
 
+    std::tuple<TCPSocket, IpAddress> TCPSocket::acceptfrom(bool nonblocking) const
+    {
+        sockaddr_storage addr{};
+        socklen_t addr_len = sizeof(addr);
+
+        auto result = accept_handle(this->handle, reinterpret_cast<sockaddr*>(&addr), &addr_len, nonblocking);
+        if (result == INVALID_NATIVE_HANDLE)
+            throw MethodError("TCPSocket::accept", "accept");
 
         return std::make_tuple(
-                    TCPSocket(system::unique_from_system_handle(static_cast<int>(result))),
-                    abl::system::to_ipaddress(reinterpret_cast<sockaddr *>(addr_ptr.get())));
+                    TCPSocket(system::socket_from_system_handle(result)),
+                    abl::system::to_ipaddress(reinterpret_cast<sockaddr *>(&addr)));
+    }
+
+    std::vector<std::tuple<TCPSocket, IpAddress>> TCPSocket::accept_batch(size_t max, bool nonblocking) const
+    {
+        std::vector<std::tuple<TCPSocket, IpAddress>> accepted;
+        while (accepted.size() < max)
+        {
+            sockaddr_storage addr{};
+            socklen_t addr_len = sizeof(addr);
+
+            auto result = accept_handle(this->handle, reinterpret_cast<sockaddr*>(&addr), &addr_len, nonblocking);
+            if (result == INVALID_NATIVE_HANDLE)
+            {
+                int code = get_error_code();
+                if (check_would_block(code))
+                    break;
+                // The connection was reset before it could be accepted. Move on to the next one.
+                if (check_connection_aborted(code))
+                    continue;
+                // Return what was accepted so far, e.g. when out of file descriptors. The error repeats on the next
+                // call if it persists.
+                if (!accepted.empty())
+                    break;
+                throw MethodError("TCPSocket::accept_batch", "accept", code);
+            }
+
+            accepted.emplace_back(TCPSocket(system::socket_from_system_handle(result)),
+                                  system::to_ipaddress(reinterpret_cast<sockaddr*>(&addr)));
+        }
+
+        return accepted;
     }
 
     void
@@ -100,7 +162,125 @@ namespace sockets
         }
 
         if (connect_result == SOCKET_ERROR)
-            throw MethodError("TCPSocket::connect", "connect");
+            throw ConnectError("TCPSocket::connect");
+    }
+
+    namespace
+    {
+        /**
+         * Puts a socket in non-blocking mode for the lifetime of the guard, then restores its previous mode.
+         */
+        class NonblockingScope
+        {
+            const SocketHandle& _handle;
+            bool _previous;
+
+        public:
+            explicit NonblockingScope(const SocketHandle& handle) : _handle(handle), _previous(is_nonblocking(handle))
+            {
+                if (!_previous)
+                    abl::set_nonblocking(_handle, true);
+            }
+
+            ~NonblockingScope()
+            {
+                if (_previous)
+                    return;
+
+                try {
+                    abl::set_nonblocking(_handle, false);
+                }
+                catch (MethodError&)
+                {
+                    // Destructors must not throw. The socket stays usable, just in non-blocking mode.
+                }
+            }
+
+            NonblockingScope(const NonblockingScope&) = delete;
+            NonblockingScope& operator=(const NonblockingScope&) = delete;
+        };
+    }
+
+    void TCPSocket::connect(const IpAddress& addr, std::chrono::milliseconds timeout)
+    {
+        using clock = std::chrono::steady_clock;
+        auto deadline = clock::now() + timeout;
+
+        NonblockingScope nonblocking(this->handle);
+        if(!start_connect(addr))
+        {
+            PollEntry entry{&this->handle, poll_event::WRITABLE, 0};
+            while(entry.ready == 0)
+            {
+                auto now = clock::now();
+                if(now >= deadline)
+                    throw ConnectError("TCPSocket::connect", get_timed_out_code());
+
+                // Round up, so the wait does not end just before the deadline
+                using rep = std::chrono::milliseconds::rep;
+                rep remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+                poll_handles(&entry, 1, static_cast<int>(std::min<rep>(remaining, std::numeric_limits<int>::max())));
+            }
+
+            int error = take_error();
+            if(error != 0)
+                throw ConnectError("TCPSocket::connect", error);
+        }
+    }
+
+    bool TCPSocket::start_connect(const IpAddress& addr)
+    {
+        sockaddr_storage storage{};
+        socklen_t length = system::from_ipaddress(addr, storage);
+
+        auto result = ::connect(system::get_system_handle(this->handle), reinterpret_cast<sockaddr*>(&storage), length);
+        if(result != SOCKET_ERROR)
+            return true;
+        if(check_connect_in_progress())
+            return false;
+        throw ConnectError("TCPSocket::start_connect");
+    }
+
+    int TCPSocket::take_error()
+    {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        auto result = ::getsockopt(system::get_system_handle(this->handle), SOL_SOCKET, SO_ERROR,
+                                   reinterpret_cast<char*>(&error), &length);
+        if(result == SOCKET_ERROR)
+            throw MethodError("TCPSocket::take_error", "getsockopt");
+        return error;
+    }
+
+    size_t TCPSocket::connect_send(const IpAddress& addr, const byte* data, size_t amount, int flags)
+    {
+#ifdef MSG_FASTOPEN
+        sockaddr_storage storage{};
+        socklen_t length = system::from_ipaddress(addr, storage);
+
+        ssize_t result = ::sendto(system::get_system_handle(this->handle), data, amount, flags | MSG_FASTOPEN,
+                                  reinterpret_cast<sockaddr*>(&storage), length);
+        if(result != SOCKET_ERROR)
+            return static_cast<size_t>(result);
+
+        int code = get_error_code();
+
+        // A non-blocking socket without a cookie sends a plain SYN and carries no data
+        if(check_connect_in_progress(code))
+            return 0;
+
+        // Fast Open is disabled for clients by the system, so fall back to a separate connect
+        if(code != EOPNOTSUPP)
+        {
+            ConnectError error("TCPSocket::connect_send", code);
+            if(error.type != ConnectError::OTHER)
+                throw error;
+            throw MethodError("TCPSocket::connect_send", "sendto", code);
+        }
+#endif
+        if(!start_connect(addr))
+            return 0;
+        return send(data, amount, flags);
     }
 
     void TCPSocket::listen(int backlog)
@@ -112,59 +292,84 @@ namespace sockets
 
     IpAddress TCPSocket::getpeername() const
     {
-        std::unique_ptr<sockaddr_storage> addr_ptr = std::make_unique<sockaddr_storage>();
-        socklen_t addr_len = sizeof(sockaddr_storage);
+        sockaddr_storage addr{};
+        socklen_t addr_len = sizeof(addr);
 
         auto result = ::getpeername(system::get_system_handle(this->handle),
-                                    reinterpret_cast<sockaddr*>(addr_ptr.get()),
+                                    reinterpret_cast<sockaddr*>(&addr),
                                     &addr_len);
         if (result == SOCKET_ERROR)
             throw MethodError("TCPSocket::getpeername", "getpeername");
 
-        return system::to_ipaddress(reinterpret_cast<sockaddr*>(addr_ptr.get()));
+        return system::to_ipaddress(reinterpret_cast<sockaddr*>(&addr));
     }
 
     IpAddress TCPSocket::getsockname() const
     {
-        std::unique_ptr<sockaddr_storage> addr_ptr = std::make_unique<sockaddr_storage>();
-        socklen_t addr_len = sizeof(sockaddr_storage);
+        sockaddr_storage addr{};
+        socklen_t addr_len = sizeof(addr);
 
         auto result = ::getsockname(system::get_system_handle(this->handle),
-                                    reinterpret_cast<sockaddr*>(addr_ptr.get()),
+                                    reinterpret_cast<sockaddr*>(&addr),
                                     &addr_len);
         if(result == SOCKET_ERROR)
             throw MethodError("TCPSocket::getsockname", "getsockname");
 
-        return system::to_ipaddress(reinterpret_cast<sockaddr*>(addr_ptr.get()));
+        return system::to_ipaddress(reinterpret_cast<sockaddr*>(&addr));
     }
 
     size_t TCPSocket::recv(ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
     {
-        // Resize the buffer to the maximum ammount
-        buffer.resize(amount + offset);
+        return stream_recv(this->handle, buffer, amount, offset, flags, "TCPSocket::recv");
+    }
 
-        // Read
-        ssize_t result = ::recv(system::get_system_handle(this->handle),
-                                reinterpret_cast<char*>(buffer.data() + offset),
-                                static_cast<int>(amount),
-                                flags);
-        if(result == SOCKET_ERROR)
-            throw SocketReadError("TCPSocket::recv");
+    size_t TCPSocket::send(const ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        return send(buffer.data() + offset, amount, flags);
+    }
+
+    size_t TCPSocket::send(const byte* data, size_t amount, int flags) const
+    {
+        return stream_send(this->handle, data, amount, flags, "TCPSocket::send");
+    }
 
-        // Resize to the read amount. This correctly sets size() on the buffer.
-        buffer.resize(static_cast<size_t>(result) + offset);
-        return static_cast<size_t>(result);
+    size_t TCPSocket::sendv(const ConstByteView* views, size_t count, int flags) const
+    {
+        return stream_sendv(this->handle, views, count, flags, "TCPSocket::sendv");
     }
 
-    size_t TCPSocket::send(const ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    size_t TCPSocket::sendv(std::initializer_list<ConstByteView> views, int flags) const
     {
-        ssize_t result =  ::send(system::get_system_handle(this->handle),
-                                 reinterpret_cast<const char*>(buffer.data() + offset),
-                                 static_cast<int>(amount),
-                                 flags);
-        if(result == SOCKET_ERROR)
-            throw SocketWriteError("TCPSocket::send");
+        return sendv(views.begin(), views.size(), flags);
+    }
+
+    size_t TCPSocket::sendv(const std::vector<ConstByteView>& views, int flags) const
+    {
+        return sendv(views.data(), views.size(), flags);
+    }
+
+    size_t TCPSocket::recvv(const ByteView* views, size_t count, int flags) const
+    {
+        return stream_recvv(this->handle, views, count, flags, "TCPSocket::recvv");
+    }
+
+    size_t TCPSocket::recvv(std::initializer_list<ByteView> views, int flags) const
+    {
+        return recvv(views.begin(), views.size(), flags);
+    }
 
-        return static_cast<size_t>(result);
+    IoResult TCPSocket::try_recv(ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        return stream_try_recv(this->handle, buffer, amount, offset, flags, "TCPSocket::try_recv");
+    }
+
+    IoResult TCPSocket::try_send(const ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        return try_send(buffer.data() + offset, amount, flags);
+    }
+
+    IoResult TCPSocket::try_send(const byte* data, size_t amount, int flags) const
+    {
+        return stream_try_send(this->handle, data, amount, flags, "TCPSocket::try_send");
     }
 }
\ No newline at end of file
@@ -0,0 +1,286 @@
+//
+// Implementation of TimerWheel.
+//
+
+#include <sockets/TimerWheel.h>
+#include <algorithm>
+#include <limits>
+
+namespace sockets {
+    const TimerWheel::timer_id TimerWheel::INVALID_TIMER;
+    const size_t TimerWheel::LEVELS;
+    const size_t TimerWheel::SLOT_BITS;
+    const size_t TimerWheel::SLOTS;
+    const uint32_t TimerWheel::NIL;
+
+    namespace
+    {
+        /**
+         * The longest delay that is placed directly. Longer timers are placed again when they reach the top level.
+         */
+        const uint64_t MAX_DELTA = (uint64_t(1) << 32) - (uint64_t(1) << 24);
+    }
+
+    TimerWheel::TimerWheel(std::chrono::milliseconds resolution, clock::time_point start) :
+    _start(start), _resolution(std::max<clock::duration>(resolution, clock::duration(1))), _current(0), _nodes(),
+    _slots(LEVELS * SLOTS, NIL), _free(NIL), _size(0), _level0_size(0)
+    {
+    }
+
+    uint64_t TimerWheel::to_tick(clock::time_point time) const
+    {
+        if (time <= _start)
+            return 0;
+        return static_cast<uint64_t>((time - _start) / _resolution);
+    }
+
+    uint64_t TimerWheel::expiry_after(clock::time_point now, std::chrono::milliseconds delay) const
+    {
+        auto due = now + std::max<clock::duration>(delay, clock::duration(0));
+
+        // Round up, so a timer never runs early
+        uint64_t expiry = due > _start ? static_cast<uint64_t>((due - _start + _resolution - clock::duration(1)) /
+                                                               _resolution) : 0;
+
+        // Ticks up to the current one have been processed already
+        return std::max(expiry, _current + 1);
+    }
+
+    uint32_t TimerWheel::allocate()
+    {
+        if (_free != NIL)
+        {
+            uint32_t index = _free;
+            _free = _nodes[index].next;
+            return index;
+        }
+
+        _nodes.push_back(Node{nullptr, 0, NIL, NIL, 1, NIL});
+        return static_cast<uint32_t>(_nodes.size() - 1);
+    }
+
+    void TimerWheel::release(uint32_t index)
+    {
+        Node& node = _nodes[index];
+        node.callback = nullptr;
+        node.slot = NIL;
+        node.prev = NIL;
+        node.next = _free;
+
+        // Generation 0 would allow an identifier equal to INVALID_TIMER
+        if (++node.generation == 0)
+            node.generation = 1;
+
+        _free = index;
+    }
+
+    void TimerWheel::link(uint32_t index)
+    {
+        Node& node = _nodes[index];
+        uint64_t delta = node.expiry > _current ? node.expiry - _current : 0;
+
+        size_t level = 0;
+        while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1))))
+            ++level;
+
+        uint64_t placement = _current + std::min(delta, MAX_DELTA);
+        auto slot = static_cast<uint32_t>(level * SLOTS + ((placement >> (SLOT_BITS * level)) & (SLOTS - 1)));
+
+        node.slot = slot;
+        node.prev = NIL;
+        node.next = _slots[slot];
+        if (node.next != NIL)
+            _nodes[node.next].prev = index;
+        _slots[slot] = index;
+
+        if (level == 0)
+            ++_level0_size;
+    }
+
+    void TimerWheel::unlink(uint32_t index)
+    {
+        Node& node = _nodes[index];
+
+        if (node.prev != NIL)
+            _nodes[node.prev].next = node.next;
+        else
+            _slots[node.slot] = node.next;
+
+        if (node.next != NIL)
+            _nodes[node.next].prev = node.prev;
+
+        if (node.slot < SLOTS)
+            --_level0_size;
+
+        node.prev = NIL;
+        node.next = NIL;
+    }
+
+    void TimerWheel::cascade(size_t level, size_t slot)
+    {
+        uint32_t index = _slots[level * SLOTS + slot];
+        _slots[level * SLOTS + slot] = NIL;
+
+        while (index != NIL)
+        {
+            uint32_t next = _nodes[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    size_t TimerWheel::run_slot(size_t slot)
+    {
+        size_t count = 0;
+
+        // Every timer in a slot of the first level is due. Callbacks may cancel the timers after them.
+        while (_slots[slot] != NIL)
+        {
+            uint32_t index = _slots[slot];
+            unlink(index);
+
+            callback_t callback = std::move(_nodes[index].callback);
+            release(index);
+            --_size;
+
+            callback();
+            ++count;
+        }
+
+        return count;
+    }
+
+    TimerWheel::Node* TimerWheel::find(timer_id id)
+    {
+        auto index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        auto generation = static_cast<uint32_t>(id >> 32u);
+
+        if (index >= _nodes.size())
+            return nullptr;
+
+        Node& node = _nodes[index];
+        if (node.slot == NIL || node.generation != generation)
+            return nullptr;
+
+        return &node;
+    }
+
+    TimerWheel::timer_id TimerWheel::schedule(std::chrono::milliseconds delay, callback_t callback,
+                                              clock::time_point now)
+    {
+        uint32_t index = allocate();
+        Node& node = _nodes[index];
+
+        node.expiry = expiry_after(now, delay);
+        node.callback = std::move(callback);
+        link(index);
+        ++_size;
+
+        return (static_cast<timer_id>(node.generation) << 32u) | index;
+    }
+
+    bool TimerWheel::reschedule(timer_id id, std::chrono::milliseconds delay, clock::time_point now)
+    {
+        Node* node = find(id);
+        if (node == nullptr)
+            return false;
+
+        auto index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        unlink(index);
+
+        node->expiry = expiry_after(now, delay);
+        link(index);
+
+        return true;
+    }
+
+    bool TimerWheel::cancel(timer_id id)
+    {
+        if (find(id) == nullptr)
+            return false;
+
+        auto index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        unlink(index);
+        release(index);
+        --_size;
+
+        return true;
+    }
+
+    size_t TimerWheel::advance(clock::time_point now)
+    {
+        uint64_t target = to_tick(now);
+        size_t count = 0;
+
+        while (_current < target)
+        {
+            if (_size == 0)
+            {
+                _current = target;
+                break;
+            }
+
+            // Nothing can run before the next cascade, so skip to the tick before it
+            if (_level0_size == 0)
+            {
+                uint64_t before_cascade = (((_current >> SLOT_BITS) + 1) << SLOT_BITS) - 1;
+                if (before_cascade > _current)
+                {
+                    _current = std::min(target, before_cascade);
+                    continue;
+                }
+            }
+
+            uint64_t tick = ++_current;
+
+            // Refill the finer levels from the top down, whenever a level wraps around
+            size_t top = 0;
+            while (top < LEVELS - 1 && (tick & ((uint64_t(1) << (SLOT_BITS * (top + 1))) - 1)) == 0)
+                ++top;
+            for (size_t level = top; level > 0; --level)
+                cascade(level, (tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+            count += run_slot(tick & (SLOTS - 1));
+        }
+
+        return count;
+    }
+
+    int TimerWheel::next_timeout_ms(clock::time_point now) const
+    {
+        if (_size == 0)
+            return -1;
+
+        // The next cascade may bring timers into the first level, so never wait past it
+        uint64_t next = ((_current >> SLOT_BITS) + 1) << SLOT_BITS;
+        if (_level0_size > 0)
+        {
+            for (uint64_t tick = _current + 1; tick < next; ++tick)
+            {
+                if (_slots[tick & (SLOTS - 1)] != NIL)
+                {
+                    next = tick;
+                    break;
+                }
+            }
+        }
+
+        auto expiry = _start + _resolution * static_cast<clock::rep>(next);
+        if (expiry <= now)
+            return 0;
+
+        // Round up, so the wait does not end just before the expiry
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(expiry - now).count() + 1;
+        return static_cast<int>(std::min<std::chrono::milliseconds::rep>(remaining, std::numeric_limits<int>::max()));
+    }
+
+    size_t TimerWheel::size() const
+    {
+        return _size;
+    }
+
+    bool TimerWheel::empty() const
+    {
+        return _size == 0;
+    }
+}
@@ -0,0 +1,237 @@
+//
+// Implementation of UDPSocket.
+//
+
+#include <sockets/abl/system.h>
+#include <sockets/abl/enums.h>
+#include <sockets/UDPSocket.h>
+#include <sockets/Error.h>
+#include <algorithm>
+
+#ifdef unix
+#include <netinet/in.h>
+#include <sys/uio.h>
+
+#define SOCKET_ERROR -1
+#endif
+
+namespace sockets
+{
+    using namespace abl;
+
+    const size_t UDPSocket::MAX_BATCH;
+
+    UDPSocket::UDPSocket() : handle() {}
+
+    UDPSocket::UDPSocket(abl::SocketHandle&& handle) : handle(std::move(handle)) {}
+
+    UDPSocket::UDPSocket(abl::ip_family fam, bool nonblocking) :
+    handle(abl::new_socket_handle(fam, sock_type::DATAGRAM, sock_proto::UDP, nonblocking)) {}
+
+    bool UDPSocket::invalid() const
+    {
+        return !this->handle;
+    }
+
+    void UDPSocket::set_nonblocking(bool nonblocking)
+    {
+        abl::set_nonblocking(this->handle, nonblocking);
+    }
+
+    void UDPSocket::bind(const IpAddress& addr)
+    {
+        sockaddr_storage storage{};
+        socklen_t length = system::from_ipaddress(addr, storage);
+
+        auto result = ::bind(system::get_system_handle(this->handle), reinterpret_cast<sockaddr*>(&storage), length);
+        if(result == SOCKET_ERROR)
+            throw MethodError("UDPSocket::bind", "bind");
+    }
+
+    void UDPSocket::connect(const IpAddress& addr)
+    {
+        sockaddr_storage storage{};
+        socklen_t length = system::from_ipaddress(addr, storage);
+
+        auto result = ::connect(system::get_system_handle(this->handle), reinterpret_cast<sockaddr*>(&storage), length);
+        if(result == SOCKET_ERROR)
+            throw MethodError("UDPSocket::connect", "connect");
+    }
+
+    IpAddress UDPSocket::getsockname() const
+    {
+        sockaddr_storage storage{};
+        socklen_t length = sizeof(storage);
+
+        auto result = ::getsockname(system::get_system_handle(this->handle),
+                                    reinterpret_cast<sockaddr*>(&storage),
+                                    &length);
+        if(result == SOCKET_ERROR)
+            throw MethodError("UDPSocket::getsockname", "getsockname");
+
+        return system::to_ipaddress(reinterpret_cast<sockaddr*>(&storage));
+    }
+
+    size_t UDPSocket::sendto(const byte* data, size_t amount, const IpAddress& to, int flags) const
+    {
+        sockaddr_storage storage{};
+        socklen_t length = system::from_ipaddress(to, storage);
+
+        auto result = ::sendto(system::get_system_handle(this->handle),
+                               reinterpret_cast<const char*>(data),
+                               static_cast<int>(amount),
+                               flags,
+                               reinterpret_cast<sockaddr*>(&storage),
+                               length);
+        if(result == SOCKET_ERROR)
+            throw SocketWriteError("UDPSocket::sendto");
+
+        return static_cast<size_t>(result);
+    }
+
+    size_t UDPSocket::sendto(const ByteBuffer& buffer, const IpAddress& to, int flags) const
+    {
+        return sendto(buffer.data(), buffer.size(), to, flags);
+    }
+
+    std::tuple<size_t, IpAddress> UDPSocket::recvfrom(ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        buffer.resize(amount + offset);
+
+        sockaddr_storage storage{};
+        socklen_t length = sizeof(storage);
+
+        auto result = ::recvfrom(system::get_system_handle(this->handle),
+                                 reinterpret_cast<char*>(buffer.data() + offset),
+                                 static_cast<int>(amount),
+                                 flags,
+                                 reinterpret_cast<sockaddr*>(&storage),
+                                 &length);
+        if(result == SOCKET_ERROR)
+        {
+            buffer.resize(offset);
+            throw SocketReadError("UDPSocket::recvfrom");
+        }
+
+        buffer.resize(static_cast<size_t>(result) + offset);
+        return std::make_tuple(static_cast<size_t>(result),
+                               system::to_ipaddress(reinterpret_cast<sockaddr*>(&storage)));
+    }
+
+    size_t UDPSocket::recv_many(Datagram* datagrams, size_t count, int flags) const
+    {
+        count = std::min(count, MAX_BATCH);
+        if(count == 0) return 0;
+
+#ifdef __linux__
+        mmsghdr messages[MAX_BATCH];
+        iovec buffers[MAX_BATCH];
+        sockaddr_storage addresses[MAX_BATCH];
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            buffers[i] = iovec{datagrams[i].data.data, datagrams[i].data.size};
+            messages[i] = mmsghdr{};
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            messages[i].msg_hdr.msg_iov = &buffers[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        // Without MSG_WAITFORONE, a blocking socket waits until the whole batch is filled.
+        int result = ::recvmmsg(system::get_system_handle(this->handle), messages, static_cast<unsigned int>(count),
+                                flags | MSG_WAITFORONE, nullptr);
+        if(result == SOCKET_ERROR)
+        {
+            if(check_would_block()) return 0;
+            throw SocketReadError("UDPSocket::recv_many");
+        }
+
+        for(int i = 0; i < result; ++i)
+        {
+            datagrams[i].data.size = messages[i].msg_len;
+            datagrams[i].address = system::to_ipaddress(reinterpret_cast<sockaddr*>(&addresses[i]));
+        }
+
+        return static_cast<size_t>(result);
+#else
+        sockaddr_storage storage{};
+        socklen_t length = sizeof(storage);
+
+        auto result = ::recvfrom(system::get_system_handle(this->handle),
+                                 reinterpret_cast<char*>(datagrams[0].data.data),
+                                 static_cast<int>(datagrams[0].data.size),
+                                 flags,
+                                 reinterpret_cast<sockaddr*>(&storage),
+                                 &length);
+        if(result == SOCKET_ERROR)
+        {
+            if(check_would_block()) return 0;
+            throw SocketReadError("UDPSocket::recv_many");
+        }
+
+        datagrams[0].data.size = static_cast<size_t>(result);
+        datagrams[0].address = system::to_ipaddress(reinterpret_cast<sockaddr*>(&storage));
+        return 1;
+#endif
+    }
+
+    size_t UDPSocket::send_many(const OutgoingDatagram* datagrams, size_t count, int flags) const
+    {
+        size_t sent = 0;
+
+#ifdef __linux__
+        mmsghdr messages[MAX_BATCH];
+        iovec buffers[MAX_BATCH];
+        sockaddr_storage addresses[MAX_BATCH];
+
+        while(sent < count)
+        {
+            size_t batch = std::min(count - sent, MAX_BATCH);
+            for(size_t i = 0; i < batch; ++i)
+            {
+                const OutgoingDatagram& datagram = datagrams[sent + i];
+                buffers[i] = iovec{const_cast<byte*>(datagram.data.data), datagram.data.size};
+
+                messages[i] = mmsghdr{};
+                messages[i].msg_hdr.msg_namelen = system::from_ipaddress(datagram.address, addresses[i]);
+                if(messages[i].msg_hdr.msg_namelen > 0)
+                    messages[i].msg_hdr.msg_name = &addresses[i];
+                messages[i].msg_hdr.msg_iov = &buffers[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            int result = ::sendmmsg(system::get_system_handle(this->handle), messages,
+                                    static_cast<unsigned int>(batch), flags);
+            if(result == SOCKET_ERROR)
+            {
+                if(check_would_block()) break;
+                throw SocketWriteError("UDPSocket::send_many");
+            }
+
+            sent += static_cast<size_t>(result);
+            if(static_cast<size_t>(result) < batch) break;
+        }
+#else
+        for(; sent < count; ++sent)
+        {
+            sockaddr_storage storage{};
+            socklen_t length = system::from_ipaddress(datagrams[sent].address, storage);
+
+            auto result = ::sendto(system::get_system_handle(this->handle),
+                                   reinterpret_cast<const char*>(datagrams[sent].data.data),
+                                   static_cast<int>(datagrams[sent].data.size),
+                                   flags,
+                                   length > 0 ? reinterpret_cast<sockaddr*>(&storage) : nullptr,
+                                   length);
+            if(result == SOCKET_ERROR)
+            {
+                if(check_would_block()) break;
+                throw SocketWriteError("UDPSocket::send_many");
+            }
+        }
+#endif
+
+        return sent;
+    }
+}
@@ -0,0 +1,186 @@
+//
+// Implementation of the I/O operations shared by the connection-oriented socket types.
+//
+
+#include <sockets/abl/stream.h>
+#include <sockets/Error.h>
+#include <algorithm>
+
+#ifdef unix
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#define SOCKET_ERROR -1
+#endif
+
+namespace sockets {
+    namespace abl {
+        native_handle_t
+        accept_handle(const SocketHandle& listener, sockaddr* addr, socklen_t* addr_len, bool nonblocking)
+        {
+#if defined(__linux__) || defined(__FreeBSD__)
+            int flags = SOCK_CLOEXEC | (nonblocking ? SOCK_NONBLOCK : 0);
+            return ::accept4(system::get_system_handle(listener), addr, addr_len, flags);
+#else
+            auto result = ::accept(system::get_system_handle(listener), addr, addr_len);
+            if (static_cast<native_handle_t>(result) == INVALID_NATIVE_HANDLE)
+                return INVALID_NATIVE_HANDLE;
+
+            SocketHandle accepted(static_cast<native_handle_t>(result));
+#ifdef FD_CLOEXEC
+            ::fcntl(result, F_SETFD, FD_CLOEXEC);
+#endif
+            if (nonblocking)
+                set_nonblocking(accepted, true);
+            return accepted.release();
+#endif
+        }
+
+        size_t
+        stream_recv(const SocketHandle& handle, ByteBuffer& buffer, size_t amount, size_t offset, int flags,
+                    const char* function_name)
+        {
+            buffer.resize(amount + offset);
+
+            ssize_t result = ::recv(system::get_system_handle(handle),
+                                    reinterpret_cast<char*>(buffer.data() + offset),
+                                    static_cast<int>(amount),
+                                    flags);
+            if(result == SOCKET_ERROR)
+                throw SocketReadError(function_name);
+
+            // Resize to the read amount. This correctly sets size() on the buffer.
+            buffer.resize(static_cast<size_t>(result) + offset);
+            return static_cast<size_t>(result);
+        }
+
+        size_t
+        stream_send(const SocketHandle& handle, const byte* data, size_t amount, int flags,
+                    const char* function_name)
+        {
+            ssize_t result = ::send(system::get_system_handle(handle),
+                                    reinterpret_cast<const char*>(data),
+                                    static_cast<int>(amount),
+                                    flags);
+            if(result == SOCKET_ERROR)
+                throw SocketWriteError(function_name);
+
+            return static_cast<size_t>(result);
+        }
+
+        size_t
+        stream_sendv(const SocketHandle& handle, const ConstByteView* views, size_t count, int flags,
+                     const char* function_name)
+        {
+            count = std::min(count, MAX_STREAM_VECTORS);
+
+#ifdef _WIN32
+            WSABUF buffers[MAX_STREAM_VECTORS];
+            for(size_t i = 0; i < count; ++i)
+                buffers[i] = WSABUF{static_cast<ULONG>(views[i].size),
+                                    reinterpret_cast<char*>(const_cast<byte*>(views[i].data))};
+
+            DWORD sent = 0;
+            int result = WSASend(system::get_system_handle(handle), buffers, static_cast<DWORD>(count), &sent,
+                                 static_cast<DWORD>(flags), nullptr, nullptr);
+            if(result == SOCKET_ERROR)
+                throw SocketWriteError(function_name);
+
+            return static_cast<size_t>(sent);
+#else
+            iovec buffers[MAX_STREAM_VECTORS];
+            for(size_t i = 0; i < count; ++i)
+                buffers[i] = iovec{const_cast<byte*>(views[i].data), views[i].size};
+
+            msghdr message{};
+            message.msg_iov = buffers;
+            message.msg_iovlen = count;
+
+            ssize_t result = ::sendmsg(system::get_system_handle(handle), &message, flags);
+            if(result == SOCKET_ERROR)
+                throw SocketWriteError(function_name);
+
+            return static_cast<size_t>(result);
+#endif
+        }
+
+        size_t
+        stream_recvv(const SocketHandle& handle, const ByteView* views, size_t count, int flags,
+                     const char* function_name)
+        {
+            count = std::min(count, MAX_STREAM_VECTORS);
+
+#ifdef _WIN32
+            WSABUF buffers[MAX_STREAM_VECTORS];
+            for(size_t i = 0; i < count; ++i)
+                buffers[i] = WSABUF{static_cast<ULONG>(views[i].size), reinterpret_cast<char*>(views[i].data)};
+
+            DWORD received = 0;
+            DWORD sys_flags = static_cast<DWORD>(flags);
+            int result = WSARecv(system::get_system_handle(handle), buffers, static_cast<DWORD>(count), &received,
+                                 &sys_flags, nullptr, nullptr);
+            if(result == SOCKET_ERROR)
+                throw SocketReadError(function_name);
+
+            return static_cast<size_t>(received);
+#else
+            iovec buffers[MAX_STREAM_VECTORS];
+            for(size_t i = 0; i < count; ++i)
+                buffers[i] = iovec{views[i].data, views[i].size};
+
+            msghdr message{};
+            message.msg_iov = buffers;
+            message.msg_iovlen = count;
+
+            ssize_t result = ::recvmsg(system::get_system_handle(handle), &message, flags);
+            if(result == SOCKET_ERROR)
+                throw SocketReadError(function_name);
+
+            return static_cast<size_t>(result);
+#endif
+        }
+
+        IoResult
+        stream_try_recv(const SocketHandle& handle, ByteBuffer& buffer, size_t amount, size_t offset, int flags,
+                        const char* function_name)
+        {
+            buffer.resize(amount + offset);
+
+            ssize_t result = ::recv(system::get_system_handle(handle),
+                                    reinterpret_cast<char*>(buffer.data() + offset),
+                                    static_cast<int>(amount),
+                                    flags);
+            if(result == SOCKET_ERROR)
+            {
+                buffer.resize(offset);
+                if(check_would_block())
+                    return IoResult{IoResult::WOULD_BLOCK, 0};
+                throw SocketReadError(function_name);
+            }
+
+            buffer.resize(static_cast<size_t>(result) + offset);
+            if(result == 0 && amount > 0)
+                return IoResult{IoResult::CLOSED, 0};
+            return IoResult{IoResult::OK, static_cast<size_t>(result)};
+        }
+
+        IoResult
+        stream_try_send(const SocketHandle& handle, const byte* data, size_t amount, int flags,
+                        const char* function_name)
+        {
+            ssize_t result = ::send(system::get_system_handle(handle),
+                                    reinterpret_cast<const char*>(data),
+                                    static_cast<int>(amount),
+                                    flags);
+            if(result == SOCKET_ERROR)
+            {
+                if(check_would_block())
+                    return IoResult{IoResult::WOULD_BLOCK, 0};
+                throw SocketWriteError(function_name);
+            }
+
+            return IoResult{IoResult::OK, static_cast<size_t>(result)};
+        }
+    }
+}
@@ -0,0 +1,251 @@
+//
+// epoll implementation of EventLoop.
+//
+
+#include <sockets/EventLoop.h>
+#include <sockets/Error.h>
+#include <sockets/abl/system.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <exception>
+#include <vector>
+
+namespace sockets {
+    namespace
+    {
+        uint32_t to_epoll_events(unsigned int events)
+        {
+            uint32_t rv = 0;
+            if (events & EventLoop::READABLE) rv |= EPOLLIN | EPOLLRDHUP;
+            if (events & EventLoop::WRITABLE) rv |= EPOLLOUT;
+            if (events & EventLoop::EDGE_TRIGGERED) rv |= EPOLLET;
+            return rv;
+        }
+
+        unsigned int from_epoll_events(uint32_t events)
+        {
+            unsigned int rv = 0;
+            if (events & EPOLLIN) rv |= EventLoop::READABLE;
+            if (events & EPOLLOUT) rv |= EventLoop::WRITABLE;
+            if (events & (EPOLLHUP | EPOLLRDHUP)) rv |= EventLoop::HANGUP;
+            if (events & EPOLLERR) rv |= EventLoop::ERROR;
+            return rv;
+        }
+
+        /**
+         * Packs a descriptor and the generation of its registration into the user data of an epoll event, so events
+         * reported for an earlier registration of a reused descriptor can be recognized.
+         */
+        uint64_t to_event_data(int descriptor, uint32_t generation)
+        {
+            return (static_cast<uint64_t>(generation) << 32u) | static_cast<uint32_t>(descriptor);
+        }
+    }
+
+    struct EventLoop::Imp
+    {
+        int epoll_fd;
+        std::vector<epoll_event> events;
+
+        struct Registration
+        {
+            callback_t callback;
+            /** Incremented whenever the descriptor is added or removed. */
+            uint32_t generation = 0;
+        };
+
+        /** Registrations indexed by file descriptor. */
+        std::vector<Registration> registrations;
+
+        bool running = false;
+    };
+
+    EventLoop::EventLoop(size_t max_events) : _imp(new Imp{})
+    {
+        _imp->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (_imp->epoll_fd == -1)
+            throw MethodError("EventLoop::EventLoop", "epoll_create1");
+
+        _imp->events.resize(max_events > 0 ? max_events : 1);
+    }
+
+    EventLoop::~EventLoop()
+    {
+        close(_imp->epoll_fd);
+    }
+
+    void EventLoop::add_descriptor(int descriptor, unsigned int events, callback_t callback)
+    {
+        auto index = static_cast<size_t>(descriptor);
+        if (_imp->registrations.size() <= index)
+            _imp->registrations.resize(index + 1);
+        auto& registration = _imp->registrations[index];
+
+        epoll_event ev{};
+        ev.events = to_epoll_events(events);
+        ev.data.u64 = to_event_data(descriptor, registration.generation + 1);
+
+        if (epoll_ctl(_imp->epoll_fd, EPOLL_CTL_ADD, descriptor, &ev) == -1)
+            throw MethodError("EventLoop::add", "epoll_ctl");
+
+        ++registration.generation;
+        registration.callback = std::move(callback);
+    }
+
+    void EventLoop::modify_descriptor(int descriptor, unsigned int events)
+    {
+        auto index = static_cast<size_t>(descriptor);
+        uint32_t generation = index < _imp->registrations.size() ? _imp->registrations[index].generation : 0;
+
+        epoll_event ev{};
+        ev.events = to_epoll_events(events);
+        ev.data.u64 = to_event_data(descriptor, generation);
+
+        if (epoll_ctl(_imp->epoll_fd, EPOLL_CTL_MOD, descriptor, &ev) == -1)
+            throw MethodError("EventLoop::modify", "epoll_ctl");
+    }
+
+    void EventLoop::remove_descriptor(int descriptor)
+    {
+        if (epoll_ctl(_imp->epoll_fd, EPOLL_CTL_DEL, descriptor, nullptr) == -1)
+            throw MethodError("EventLoop::remove", "epoll_ctl");
+
+        auto index = static_cast<size_t>(descriptor);
+        if (index < _imp->registrations.size())
+        {
+            // If the callback is currently executing, poll() holds it and destroys it once it returns
+            auto& registration = _imp->registrations[index];
+            registration.callback = nullptr;
+            ++registration.generation;
+        }
+    }
+
+    void EventLoop::add(const TCPSocket& socket, unsigned int events, callback_t callback)
+    {
+        add_descriptor(abl::system::get_system_handle(socket.handle), events, std::move(callback));
+    }
+
+    void EventLoop::add(const TCPServerSocket& server, callback_t callback)
+    {
+        add(server.get_socket(), READABLE, std::move(callback));
+    }
+
+    void EventLoop::add(const UnixStreamSocket& socket, unsigned int events, callback_t callback)
+    {
+        add_descriptor(abl::system::get_system_handle(socket.handle), events, std::move(callback));
+    }
+
+    void EventLoop::add(const UnixServerSocket& server, callback_t callback)
+    {
+        add(server.get_socket(), READABLE, std::move(callback));
+    }
+
+    void EventLoop::modify(const TCPSocket& socket, unsigned int events)
+    {
+        modify_descriptor(abl::system::get_system_handle(socket.handle), events);
+    }
+
+    void EventLoop::modify(const UnixStreamSocket& socket, unsigned int events)
+    {
+        modify_descriptor(abl::system::get_system_handle(socket.handle), events);
+    }
+
+    void EventLoop::remove(const TCPSocket& socket)
+    {
+        remove_descriptor(abl::system::get_system_handle(socket.handle));
+    }
+
+    void EventLoop::remove(const TCPServerSocket& server)
+    {
+        remove(server.get_socket());
+    }
+
+    void EventLoop::remove(const UnixStreamSocket& socket)
+    {
+        remove_descriptor(abl::system::get_system_handle(socket.handle));
+    }
+
+    void EventLoop::remove(const UnixServerSocket& server)
+    {
+        remove(server.get_socket());
+    }
+
+    size_t EventLoop::poll(int timeout_ms)
+    {
+        int count = epoll_wait(_imp->epoll_fd,
+                               _imp->events.data(),
+                               static_cast<int>(_imp->events.size()),
+                               timeout_ms);
+        if (count == -1)
+        {
+            if (errno == EINTR) return 0;
+            throw MethodError("EventLoop::poll", "epoll_wait");
+        }
+
+        size_t dispatched = 0;
+        std::exception_ptr error;
+        for (int i = 0; i < count; ++i)
+        {
+            uint64_t data = _imp->events[i].data.u64;
+            auto index = static_cast<size_t>(data & 0xFFFFFFFFu);
+            auto generation = static_cast<uint32_t>(data >> 32u);
+
+            // The socket may have been removed by a callback earlier in this batch, and its descriptor reused
+            if (index >= _imp->registrations.size() || _imp->registrations[index].generation != generation ||
+                !_imp->registrations[index].callback)
+                continue;
+
+            // Take the callback out while it runs, since it may add sockets and thereby move the registrations
+            callback_t callback = std::move(_imp->registrations[index].callback);
+            _imp->registrations[index].callback = nullptr;
+
+            // Dispatch the rest of the batch before reporting a failure, since epoll_wait() will not return it again
+            try
+            {
+                callback(from_epoll_events(_imp->events[i].events));
+            }
+            catch (...)
+            {
+                if (!error) error = std::current_exception();
+            }
+
+            // Put it back, unless the socket was removed or registered again in the meantime
+            if (_imp->registrations[index].generation == generation)
+                _imp->registrations[index].callback = std::move(callback);
+            ++dispatched;
+        }
+
+        if (error) std::rethrow_exception(error);
+        return dispatched;
+    }
+
+    size_t EventLoop::poll(TimerWheel& timers, int timeout_ms)
+    {
+        int wait = timers.next_timeout_ms();
+        if (timeout_ms >= 0 && (wait < 0 || timeout_ms < wait))
+            wait = timeout_ms;
+
+        size_t dispatched = poll(wait);
+        return dispatched + timers.advance();
+    }
+
+    void EventLoop::run()
+    {
+        _imp->running = true;
+        while (_imp->running)
+            poll();
+    }
+
+    void EventLoop::run(TimerWheel& timers)
+    {
+        _imp->running = true;
+        while (_imp->running)
+            poll(timers);
+    }
+
+    void EventLoop::stop()
+    {
+        _imp->running = false;
+    }
+}
@@ -0,0 +1,398 @@
+//
+// io_uring implementation of IoUring. The rings are set up and driven with the raw system calls.
+//
+
+#include <sockets/IoUring.h>
+#include <sockets/Error.h>
+#include <sockets/abl/system.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace sockets {
+    namespace
+    {
+        int io_uring_setup(unsigned int entries, io_uring_params* params)
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int io_uring_enter(int fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags)
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        int io_uring_register(int fd, unsigned int opcode, const void* arg, unsigned int nr_args)
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+        }
+
+        template<typename T>
+        T* ring_field(void* ring, uint32_t offset)
+        {
+            return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+        }
+    }
+
+    struct IoUring::Imp
+    {
+        int ring_fd = -1;
+
+        void* sq_ring = MAP_FAILED;
+        size_t sq_ring_size = 0;
+        void* cq_ring = MAP_FAILED;
+        size_t cq_ring_size = 0;
+        io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        size_t sqes_size = 0;
+
+        unsigned int* sq_head = nullptr;
+        unsigned int* sq_tail = nullptr;
+        unsigned int sq_mask = 0;
+        unsigned int sq_entries = 0;
+        unsigned int* sq_array = nullptr;
+
+        unsigned int* cq_head = nullptr;
+        unsigned int* cq_tail = nullptr;
+        unsigned int cq_mask = 0;
+        io_uring_cqe* cqes = nullptr;
+
+        /** Number of entries published to the submission ring, but not yet submitted to the kernel */
+        unsigned int pending = 0;
+
+        /** Buffers registered with register_buffers() */
+        std::vector<iovec> registered;
+
+        ~Imp()
+        {
+            if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+            if (cq_ring != MAP_FAILED && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+            if (sq_ring != MAP_FAILED) munmap(sq_ring, sq_ring_size);
+            if (ring_fd != -1) close(ring_fd);
+        }
+
+        /**
+         * Returns a cleared submission entry. If the submission ring is full, queued entries are submitted first.
+         */
+        io_uring_sqe* next_sqe(const char* function_name)
+        {
+            unsigned int tail = *sq_tail;
+            if (tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries)
+            {
+                submit(function_name);
+                if (tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries)
+                    throw InvalidStateError("IoUring", function_name, "submission queue is full");
+            }
+
+            unsigned int index = tail & sq_mask;
+            io_uring_sqe* sqe = &sqes[index];
+            std::memset(sqe, 0, sizeof(io_uring_sqe));
+            sq_array[index] = index;
+            return sqe;
+        }
+
+        /**
+         * Publishes the entry returned by the last call to next_sqe().
+         */
+        void push_sqe()
+        {
+            __atomic_store_n(sq_tail, *sq_tail + 1, __ATOMIC_RELEASE);
+            ++pending;
+        }
+
+        unsigned int enter(unsigned int min_complete, const char* function_name)
+        {
+            unsigned int flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+            int result;
+            do
+            {
+                result = io_uring_enter(ring_fd, pending, min_complete, flags);
+            } while (result == -1 && errno == EINTR);
+
+            if (result == -1)
+                throw MethodError(std::string("IoUring::") + function_name, "io_uring_enter");
+
+            auto submitted = static_cast<unsigned int>(result);
+            pending -= submitted;
+            return submitted;
+        }
+
+        unsigned int submit(const char* function_name)
+        {
+            if (pending == 0) return 0;
+            return enter(0, function_name);
+        }
+
+        size_t reap(const completion_handler_t& handler)
+        {
+            size_t count = 0;
+            unsigned int head = *cq_head;
+
+            while (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+            {
+                const io_uring_cqe& cqe = cqes[head & cq_mask];
+                Completion completion{cqe.user_data, cqe.res, cqe.flags};
+
+                // Release the entry before dispatching, so the handler may queue new operations.
+                ++head;
+                __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+
+                handler(completion);
+                ++count;
+            }
+
+            return count;
+        }
+
+        void prep_rw(uint8_t opcode, int fd, const void* addr, size_t len, const char* function_name,
+                     uint64_t user_data)
+        {
+            io_uring_sqe* sqe = next_sqe(function_name);
+            sqe->opcode = opcode;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<uint64_t>(addr);
+            sqe->len = static_cast<uint32_t>(len);
+            sqe->user_data = user_data;
+            push_sqe();
+        }
+    };
+
+    bool IoUring::Completion::failed() const
+    {
+        return result < 0;
+    }
+
+    int IoUring::Completion::error() const
+    {
+        return result < 0 ? -result : 0;
+    }
+
+    bool IoUring::Completion::more() const
+    {
+#ifdef IORING_CQE_F_MORE
+        return (flags & IORING_CQE_F_MORE) != 0;
+#else
+        return false;
+#endif
+    }
+
+    bool IoUring::Completion::has_buffer() const
+    {
+        return (flags & IORING_CQE_F_BUFFER) != 0;
+    }
+
+    uint16_t IoUring::Completion::buffer_id() const
+    {
+        return static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+    }
+
+    TCPSocket IoUring::Completion::accepted_socket() const
+    {
+        if (failed())
+            throw MethodError("IoUring::Completion::accepted_socket", "accept", error());
+        return TCPSocket(abl::system::socket_from_system_handle(result));
+    }
+
+    IoUring::IoUring(unsigned int entries) : _imp(new Imp{})
+    {
+        io_uring_params params{};
+        _imp->ring_fd = io_uring_setup(entries, &params);
+        if (_imp->ring_fd == -1)
+            throw MethodError("IoUring::IoUring", "io_uring_setup");
+
+        _imp->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        _imp->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap)
+            _imp->sq_ring_size = _imp->cq_ring_size = std::max(_imp->sq_ring_size, _imp->cq_ring_size);
+
+        _imp->sq_ring = mmap(nullptr, _imp->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             _imp->ring_fd, IORING_OFF_SQ_RING);
+        if (_imp->sq_ring == MAP_FAILED)
+            throw MethodError("IoUring::IoUring", "mmap");
+
+        if (single_mmap)
+        {
+            _imp->cq_ring = _imp->sq_ring;
+        }
+        else
+        {
+            _imp->cq_ring = mmap(nullptr, _imp->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                 _imp->ring_fd, IORING_OFF_CQ_RING);
+            if (_imp->cq_ring == MAP_FAILED)
+                throw MethodError("IoUring::IoUring", "mmap");
+        }
+
+        _imp->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, _imp->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          _imp->ring_fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+            throw MethodError("IoUring::IoUring", "mmap");
+        _imp->sqes = static_cast<io_uring_sqe*>(sqes);
+
+        _imp->sq_head = ring_field<unsigned int>(_imp->sq_ring, params.sq_off.head);
+        _imp->sq_tail = ring_field<unsigned int>(_imp->sq_ring, params.sq_off.tail);
+        _imp->sq_mask = *ring_field<unsigned int>(_imp->sq_ring, params.sq_off.ring_mask);
+        _imp->sq_entries = *ring_field<unsigned int>(_imp->sq_ring, params.sq_off.ring_entries);
+        _imp->sq_array = ring_field<unsigned int>(_imp->sq_ring, params.sq_off.array);
+
+        _imp->cq_head = ring_field<unsigned int>(_imp->cq_ring, params.cq_off.head);
+        _imp->cq_tail = ring_field<unsigned int>(_imp->cq_ring, params.cq_off.tail);
+        _imp->cq_mask = *ring_field<unsigned int>(_imp->cq_ring, params.cq_off.ring_mask);
+        _imp->cqes = ring_field<io_uring_cqe>(_imp->cq_ring, params.cq_off.cqes);
+    }
+
+    IoUring::~IoUring() = default;
+
+    void IoUring::accept(const TCPSocket& listener, uint64_t user_data, bool multishot)
+    {
+#ifndef IORING_ACCEPT_MULTISHOT
+        if (multishot)
+            throw InvalidStateError("IoUring", __func__, "multishot accept is not supported by this build");
+#endif
+
+        io_uring_sqe* sqe = _imp->next_sqe("accept");
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = abl::system::get_system_handle(listener.handle);
+        sqe->accept_flags = SOCK_CLOEXEC;
+#ifdef IORING_ACCEPT_MULTISHOT
+        if (multishot) sqe->ioprio |= IORING_ACCEPT_MULTISHOT;
+#endif
+        sqe->user_data = user_data;
+        _imp->push_sqe();
+    }
+
+    void IoUring::recv(const TCPSocket& socket, ByteBuffer& buffer, size_t amount, size_t offset,
+                       uint64_t user_data)
+    {
+        if (buffer.size() < offset + amount)
+            throw std::invalid_argument("IoUring::recv: buffer is smaller than offset + amount");
+
+        _imp->prep_rw(IORING_OP_RECV, abl::system::get_system_handle(socket.handle), buffer.data() + offset,
+                      amount, "recv", user_data);
+    }
+
+    void IoUring::send(const TCPSocket& socket, const ByteBuffer& buffer, size_t amount, size_t offset,
+                       uint64_t user_data)
+    {
+        if (buffer.size() < offset + amount)
+            throw std::invalid_argument("IoUring::send: buffer is smaller than offset + amount");
+
+        _imp->prep_rw(IORING_OP_SEND, abl::system::get_system_handle(socket.handle), buffer.data() + offset,
+                      amount, "send", user_data);
+    }
+
+    void IoUring::register_buffers(std::vector<ByteBuffer>& buffers)
+    {
+        unregister_buffers();
+
+        std::vector<iovec> iovecs;
+        iovecs.reserve(buffers.size());
+        for (auto& buffer : buffers)
+            iovecs.push_back(iovec{buffer.data(), buffer.size()});
+
+        if (io_uring_register(_imp->ring_fd, IORING_REGISTER_BUFFERS, iovecs.data(),
+                              static_cast<unsigned int>(iovecs.size())) == -1)
+            throw MethodError("IoUring::register_buffers", "io_uring_register");
+        _imp->registered = std::move(iovecs);
+    }
+
+    void IoUring::unregister_buffers()
+    {
+        if (_imp->registered.empty()) return;
+
+        if (io_uring_register(_imp->ring_fd, IORING_UNREGISTER_BUFFERS, nullptr, 0) == -1)
+            throw MethodError("IoUring::unregister_buffers", "io_uring_register");
+        _imp->registered.clear();
+    }
+
+    void IoUring::recv_fixed(const TCPSocket& socket, unsigned int index, size_t amount, size_t offset,
+                             uint64_t user_data)
+    {
+        if (index >= _imp->registered.size() || _imp->registered[index].iov_len < offset + amount)
+            throw std::invalid_argument("IoUring::recv_fixed: range is outside of the registered buffer");
+
+        _imp->prep_rw(IORING_OP_READ_FIXED, abl::system::get_system_handle(socket.handle),
+                      static_cast<byte*>(_imp->registered[index].iov_base) + offset, amount, "recv_fixed",
+                      user_data);
+        _imp->sqes[(*_imp->sq_tail - 1) & _imp->sq_mask].buf_index = static_cast<uint16_t>(index);
+    }
+
+    void IoUring::send_fixed(const TCPSocket& socket, unsigned int index, size_t amount, size_t offset,
+                             uint64_t user_data)
+    {
+        if (index >= _imp->registered.size() || _imp->registered[index].iov_len < offset + amount)
+            throw std::invalid_argument("IoUring::send_fixed: range is outside of the registered buffer");
+
+        _imp->prep_rw(IORING_OP_WRITE_FIXED, abl::system::get_system_handle(socket.handle),
+                      static_cast<byte*>(_imp->registered[index].iov_base) + offset, amount, "send_fixed",
+                      user_data);
+        _imp->sqes[(*_imp->sq_tail - 1) & _imp->sq_mask].buf_index = static_cast<uint16_t>(index);
+    }
+
+    void IoUring::provide_buffers(uint16_t group, byte* base, unsigned int buffer_size, unsigned int count,
+                                  uint16_t first_id, uint64_t user_data)
+    {
+        io_uring_sqe* sqe = _imp->next_sqe("provide_buffers");
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = static_cast<int>(count);
+        sqe->addr = reinterpret_cast<uint64_t>(base);
+        sqe->len = buffer_size;
+        sqe->off = first_id;
+        sqe->buf_group = group;
+        sqe->user_data = user_data;
+        _imp->push_sqe();
+    }
+
+    void IoUring::recv_multishot(const TCPSocket& socket, uint16_t group, uint64_t user_data)
+    {
+#ifndef IORING_RECV_MULTISHOT
+        (void) socket; (void) group; (void) user_data;
+        throw InvalidStateError("IoUring", __func__, "multishot receive is not supported by this build");
+#else
+        io_uring_sqe* sqe = _imp->next_sqe("recv_multishot");
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = abl::system::get_system_handle(socket.handle);
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = group;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->user_data = user_data;
+        _imp->push_sqe();
+#endif
+    }
+
+    void IoUring::cancel(uint64_t target_user_data, uint64_t user_data)
+    {
+        io_uring_sqe* sqe = _imp->next_sqe("cancel");
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = target_user_data;
+        sqe->user_data = user_data;
+        _imp->push_sqe();
+    }
+
+    unsigned int IoUring::submit()
+    {
+        return _imp->submit("submit");
+    }
+
+    size_t IoUring::wait(unsigned int min_complete, const completion_handler_t& handler)
+    {
+        unsigned int ready = __atomic_load_n(_imp->cq_tail, __ATOMIC_ACQUIRE) - *_imp->cq_head;
+        if (_imp->pending > 0 || ready < min_complete)
+            _imp->enter(min_complete, "wait");
+
+        return _imp->reap(handler);
+    }
+
+    size_t IoUring::reap(const completion_handler_t& handler)
+    {
+        return _imp->reap(handler);
+    }
+}
@@ -0,0 +1,172 @@
+//
+// Linux-specific TCPSocket functionality.
+//
+
+#include <sockets/TCPSocket.h>
+#include <sockets/Error.h>
+#include <sockets/abl/system.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+
+namespace sockets
+{
+    using namespace abl;
+
+    namespace
+    {
+        /**
+         * Closes a file descriptor when it goes out of scope.
+         */
+        struct ScopedDescriptor
+        {
+            int descriptor;
+
+            explicit ScopedDescriptor(int descriptor) : descriptor(descriptor) {}
+            ScopedDescriptor(const ScopedDescriptor&) = delete;
+            ScopedDescriptor& operator=(const ScopedDescriptor&) = delete;
+
+            ~ScopedDescriptor()
+            {
+                if (descriptor != -1) close(descriptor);
+            }
+        };
+
+        /** The largest amount the kernel transfers in one call to sendfile() or splice() */
+        const size_t MAX_TRANSFER = 0x7ffff000;
+    }
+
+    size_t TCPSocket::sendfile(int file_descriptor, size_t offset, size_t amount) const
+    {
+        auto file_offset = static_cast<off_t>(offset);
+
+        ssize_t result = ::sendfile(system::get_system_handle(this->handle),
+                                    file_descriptor,
+                                    &file_offset,
+                                    std::min(amount, MAX_TRANSFER));
+        if (result == -1)
+            throw SocketWriteError("TCPSocket::sendfile");
+
+        return static_cast<size_t>(result);
+    }
+
+    size_t TCPSocket::sendfile(const std::string& path, size_t offset, size_t amount) const
+    {
+        ScopedDescriptor file(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (file.descriptor == -1)
+            throw MethodError("TCPSocket::sendfile", "open");
+
+        size_t total = 0;
+        while (total < amount)
+        {
+            size_t sent = sendfile(file.descriptor, offset + total, amount - total);
+            // The end of the file has been reached
+            if (sent == 0) break;
+            total += sent;
+        }
+
+        return total;
+    }
+
+    size_t relay(const TCPSocket& from, const TCPSocket& to, size_t amount)
+    {
+        int pipe_descriptors[2];
+        if (pipe2(pipe_descriptors, O_CLOEXEC) == -1)
+            throw MethodError("relay", "pipe2");
+
+        ScopedDescriptor pipe_read(pipe_descriptors[0]);
+        ScopedDescriptor pipe_write(pipe_descriptors[1]);
+
+        int from_handle = system::get_system_handle(from.handle);
+        int to_handle = system::get_system_handle(to.handle);
+
+        size_t total = 0;
+        while (total < amount)
+        {
+            // Move received bytes into the pipe
+            ssize_t received = splice(from_handle, nullptr, pipe_write.descriptor, nullptr,
+                                      std::min(amount - total, MAX_TRANSFER), SPLICE_F_MOVE);
+            if (received == -1)
+            {
+                if (errno == EINTR) continue;
+                throw MethodError("relay", "splice");
+            }
+            // The peer closed the connection
+            if (received == 0) break;
+
+            // Drain the pipe into the destination
+            auto buffered = static_cast<size_t>(received);
+            while (buffered > 0)
+            {
+                ssize_t sent = splice(pipe_read.descriptor, nullptr, to_handle, nullptr, buffered,
+                                      SPLICE_F_MOVE);
+                if (sent == -1)
+                {
+                    if (errno == EINTR) continue;
+                    throw MethodError("relay", "splice");
+                }
+                buffered -= static_cast<size_t>(sent);
+            }
+
+            total += static_cast<size_t>(received);
+        }
+
+        return total;
+    }
+
+    void TCPSocket::enable_zerocopy()
+    {
+        int value = 1;
+        if (setsockopt(system::get_system_handle(this->handle), SOL_SOCKET, SO_ZEROCOPY, &value, sizeof(value)) == -1)
+            throw MethodError("TCPSocket::enable_zerocopy", "setsockopt");
+    }
+
+    size_t TCPSocket::send_zerocopy(const byte* data, size_t amount, int flags) const
+    {
+        ssize_t result = ::send(system::get_system_handle(this->handle), data, amount, flags | MSG_ZEROCOPY);
+        if (result == -1)
+            throw SocketWriteError("TCPSocket::send_zerocopy");
+
+        return static_cast<size_t>(result);
+    }
+
+    size_t TCPSocket::reap_zerocopy(const zerocopy_handler_t& handler) const
+    {
+        int socket = system::get_system_handle(this->handle);
+        size_t count = 0;
+
+        while (true)
+        {
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+
+            msghdr message{};
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+
+            if (recvmsg(socket, &message, MSG_ERRQUEUE | MSG_DONTWAIT) == -1)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return count;
+                if (errno == EINTR) continue;
+                throw MethodError("TCPSocket::reap_zerocopy", "recvmsg");
+            }
+
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+            {
+                bool is_error = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                                (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+                if (!is_error) continue;
+
+                auto error = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+                if (error->ee_origin != SO_EE_ORIGIN_ZEROCOPY || error->ee_errno != 0) continue;
+
+                handler(error->ee_info, error->ee_data, (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0);
+                ++count;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+//
+// Linux-specific UDPSocket functionality.
+//
+
+#include <sockets/UDPSocket.h>
+#include <sockets/Error.h>
+#include <sockets/abl/system.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <cstring>
+
+namespace sockets
+{
+    using namespace abl;
+
+    size_t UDPSocket::send_segmented(const byte* data, size_t amount, uint16_t segment_size, const IpAddress& to,
+                                     int flags) const
+    {
+        sockaddr_storage storage{};
+        socklen_t length = system::from_ipaddress(to, storage);
+
+        iovec buffer{const_cast<byte*>(data), amount};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+
+        msghdr message{};
+        message.msg_name = length > 0 ? &storage : nullptr;
+        message.msg_namelen = length;
+        message.msg_iov = &buffer;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        std::memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+
+        ssize_t result = ::sendmsg(system::get_system_handle(this->handle), &message, flags);
+        if(result == -1)
+            throw SocketWriteError("UDPSocket::send_segmented");
+
+        return static_cast<size_t>(result);
+    }
+
+    void UDPSocket::enable_gro(bool enable)
+    {
+        int value = enable ? 1 : 0;
+        if(setsockopt(system::get_system_handle(this->handle), SOL_UDP, UDP_GRO, &value, sizeof(value)) == -1)
+            throw MethodError("UDPSocket::enable_gro", "setsockopt");
+    }
+
+    std::tuple<size_t, size_t, IpAddress>
+    UDPSocket::recv_coalesced(ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        buffer.resize(amount + offset);
+
+        sockaddr_storage storage{};
+        iovec vector{buffer.data() + offset, amount};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+
+        msghdr message{};
+        message.msg_name = &storage;
+        message.msg_namelen = sizeof(storage);
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t result = ::recvmsg(system::get_system_handle(this->handle), &message, flags);
+        if(result == -1)
+        {
+            buffer.resize(offset);
+            throw SocketReadError("UDPSocket::recv_coalesced");
+        }
+
+        auto received = static_cast<size_t>(result);
+        size_t segment_size = received;
+        for(cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+        {
+            if(cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+            {
+                int value;
+                std::memcpy(&value, CMSG_DATA(cmsg), sizeof(value));
+                segment_size = static_cast<size_t>(value);
+            }
+        }
+
+        buffer.resize(received + offset);
+        return std::make_tuple(received, segment_size, system::to_ipaddress(reinterpret_cast<sockaddr*>(&storage)));
+    }
+}
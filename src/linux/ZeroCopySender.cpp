@@ -0,0 +1,80 @@
+//
+// MSG_ZEROCOPY implementation of ZeroCopySender.
+//
+
+#include <sockets/ZeroCopySender.h>
+#include <sockets/Error.h>
+#include <sockets/abl/system.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace sockets {
+    ZeroCopySender::ZeroCopySender(TCPSocket& socket, size_t threshold) :
+    _socket(socket), _threshold(threshold), _next_id(0), _in_flight(), _copied(false)
+    {
+        // Earlier zero-copy sends would shift the numbers the system gives to ours
+        int enabled = 0;
+        socklen_t length = sizeof(enabled);
+        if (getsockopt(abl::system::get_system_handle(_socket.handle), SOL_SOCKET, SO_ZEROCOPY, &enabled, &length) == 0
+            && enabled != 0)
+            throw InvalidStateError("ZeroCopySender", __func__, "zero-copy is already enabled on the socket");
+
+        _socket.enable_zerocopy();
+    }
+
+    size_t ZeroCopySender::send(const SharedByteBuffer& buffer, size_t amount, size_t offset)
+    {
+        if (!buffer || buffer->size() < offset + amount)
+            throw std::invalid_argument("ZeroCopySender::send: buffer is smaller than offset + amount");
+
+        if (amount < _threshold)
+            return _socket.send(buffer->data() + offset, amount);
+
+        size_t sent = _socket.send_zerocopy(buffer->data() + offset, amount);
+        if (sent > 0)
+            _in_flight.emplace_back(_next_id++, buffer);
+
+        return sent;
+    }
+
+    size_t ZeroCopySender::reap()
+    {
+        size_t before = _in_flight.size();
+
+        _socket.reap_zerocopy([this](uint32_t first, uint32_t last, bool copied)
+        {
+            // Numbers wrap around, so last is past the most recent send if it is less than half the range ahead
+            if (static_cast<uint32_t>(_next_id - 1 - last) > static_cast<uint32_t>(std::numeric_limits<int32_t>::max()))
+                throw InvalidStateError("ZeroCopySender", "reap",
+                                        "the system completed a zero-copy send that this sender did not make");
+
+            _copied = _copied || copied;
+
+            // Ranges are inclusive and the numbers may wrap around.
+            auto completed = [first, last](const std::pair<uint32_t, SharedByteBuffer>& entry)
+            {
+                return entry.first - first <= last - first;
+            };
+
+            // Completions usually arrive in order, so released buffers are at the front of the queue.
+            while (!_in_flight.empty() && completed(_in_flight.front()))
+                _in_flight.pop_front();
+
+            _in_flight.erase(std::remove_if(_in_flight.begin(), _in_flight.end(), completed), _in_flight.end());
+        });
+
+        return before - _in_flight.size();
+    }
+
+    size_t ZeroCopySender::in_flight() const
+    {
+        return _in_flight.size();
+    }
+
+    bool ZeroCopySender::copied() const
+    {
+        return _copied;
+    }
+}
@@ -18,6 +18,26 @@ namespace sockets {
         return errno == ECONNRESET;
     }
 
+    bool check_would_block(int code)
+    {
+        return code == EAGAIN || code == EWOULDBLOCK;
+    }
+
+    bool check_connection_aborted(int code)
+    {
+        return code == ECONNABORTED || code == EPROTO;
+    }
+
+    bool check_connect_in_progress(int code)
+    {
+        return code == EINPROGRESS;
+    }
+
+    int get_timed_out_code()
+    {
+        return ETIMEDOUT;
+    }
+
     SocketReadError::ErrorType SocketReadError::map_error_type(int code)
     {
         switch (code)
@@ -39,6 +59,26 @@ namespace sockets {
         }
     }
 
+    ConnectError::ErrorType ConnectError::map_error_type(int code)
+    {
+        switch (code)
+        {
+            case ETIMEDOUT:
+                return ErrorType::TIMED_OUT;
+            case ECONNREFUSED:
+                return ErrorType::CONNECTION_REFUSED;
+            case ENETUNREACH:
+                return ErrorType::NETWORK_UNREACHABLE;
+            case EHOSTUNREACH:
+                return ErrorType::HOST_UNREACHABLE;
+            case EADDRINUSE:
+            case EADDRNOTAVAIL:
+                return ErrorType::ADDRESS_IN_USE;
+            default:
+                return ErrorType::OTHER;
+        }
+    }
+
     SocketWriteError::ErrorType SocketWriteError::map_error_type(int code)
     {
         switch (code)
@@ -0,0 +1,129 @@
+//
+// Implementation of UnixDatagramSocket.
+//
+
+#include <sockets/UnixDatagramSocket.h>
+#include <sockets/Error.h>
+#include <sockets/abl/system.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+
+namespace sockets
+{
+    using namespace abl;
+
+    UnixDatagramSocket::UnixDatagramSocket() : handle() {}
+
+    UnixDatagramSocket::UnixDatagramSocket(abl::SocketHandle&& handle) : handle(std::move(handle)) {}
+
+    UnixDatagramSocket UnixDatagramSocket::open(bool nonblocking)
+    {
+        return UnixDatagramSocket(new_socket_handle(ip_family::LOCAL, sock_type::DATAGRAM, sock_proto::DEFAULT,
+                                                    nonblocking));
+    }
+
+    std::tuple<UnixDatagramSocket, UnixDatagramSocket> UnixDatagramSocket::pair()
+    {
+        int sys_type = system::sttosys(sock_type::DATAGRAM);
+#ifdef SOCK_CLOEXEC
+        sys_type |= SOCK_CLOEXEC;
+#endif
+
+        int descriptors[2];
+        if(::socketpair(AF_UNIX, sys_type, 0, descriptors) == -1)
+            throw MethodError("UnixDatagramSocket::pair", "socketpair");
+
+        auto rv = std::make_tuple(UnixDatagramSocket(system::socket_from_system_handle(descriptors[0])),
+                                  UnixDatagramSocket(system::socket_from_system_handle(descriptors[1])));
+#ifndef SOCK_CLOEXEC
+        ::fcntl(descriptors[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(descriptors[1], F_SETFD, FD_CLOEXEC);
+#endif
+        return rv;
+    }
+
+    bool UnixDatagramSocket::invalid() const
+    {
+        return !this->handle;
+    }
+
+    void UnixDatagramSocket::set_nonblocking(bool nonblocking)
+    {
+        abl::set_nonblocking(this->handle, nonblocking);
+    }
+
+    void UnixDatagramSocket::bind(const LocalAddress& addr)
+    {
+        sockaddr_storage storage{};
+        socklen_t length = system::from_localaddress(addr, storage);
+
+        if(::bind(system::get_system_handle(this->handle), reinterpret_cast<sockaddr*>(&storage), length) == -1)
+            throw MethodError("UnixDatagramSocket::bind", "bind");
+    }
+
+    void UnixDatagramSocket::connect(const LocalAddress& addr)
+    {
+        sockaddr_storage storage{};
+        socklen_t length = system::from_localaddress(addr, storage);
+
+        if(::connect(system::get_system_handle(this->handle), reinterpret_cast<sockaddr*>(&storage), length) == -1)
+            throw MethodError("UnixDatagramSocket::connect", "connect");
+    }
+
+    LocalAddress UnixDatagramSocket::getsockname() const
+    {
+        sockaddr_storage storage{};
+        socklen_t length = sizeof(storage);
+
+        if(::getsockname(system::get_system_handle(this->handle), reinterpret_cast<sockaddr*>(&storage), &length) == -1)
+            throw MethodError("UnixDatagramSocket::getsockname", "getsockname");
+
+        return system::to_localaddress(storage, length);
+    }
+
+    size_t UnixDatagramSocket::sendto(const byte* data, size_t amount, const LocalAddress& to, int flags) const
+    {
+        sockaddr_storage storage{};
+        socklen_t length = system::from_localaddress(to, storage);
+
+        ssize_t result = ::sendto(system::get_system_handle(this->handle), data, amount, flags,
+                                  reinterpret_cast<sockaddr*>(&storage), length);
+        if(result == -1)
+            throw SocketWriteError("UnixDatagramSocket::sendto");
+
+        return static_cast<size_t>(result);
+    }
+
+    size_t UnixDatagramSocket::send(const byte* data, size_t amount, int flags) const
+    {
+        ssize_t result = ::send(system::get_system_handle(this->handle), data, amount, flags);
+        if(result == -1)
+            throw SocketWriteError("UnixDatagramSocket::send");
+
+        return static_cast<size_t>(result);
+    }
+
+    std::tuple<size_t, LocalAddress>
+    UnixDatagramSocket::recvfrom(ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        buffer.resize(amount + offset);
+
+        sockaddr_storage storage{};
+        socklen_t length = sizeof(storage);
+
+        ssize_t result = ::recvfrom(system::get_system_handle(this->handle), buffer.data() + offset, amount, flags,
+                                    reinterpret_cast<sockaddr*>(&storage), &length);
+        if(result == -1)
+        {
+            buffer.resize(offset);
+            throw SocketReadError("UnixDatagramSocket::recvfrom");
+        }
+
+        buffer.resize(static_cast<size_t>(result) + offset);
+
+        // Datagrams from an unbound sender carry no address at all, not even the family
+        if(length < sizeof(sa_family_t))
+            return std::make_tuple(static_cast<size_t>(result), LocalAddress());
+        return std::make_tuple(static_cast<size_t>(result), system::to_localaddress(storage, length));
+    }
+}
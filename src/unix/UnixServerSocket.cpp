@@ -0,0 +1,57 @@
+//
+// Implementation of UnixServerSocket.
+//
+
+#include <sockets/UnixServerSocket.h>
+#include <sockets/Error.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace sockets {
+    namespace
+    {
+        /**
+         * Removes the socket at the path if it exists but refuses connections.
+         */
+        void remove_stale_socket(const abl::LocalAddress& addr, abl::sock_type type)
+        {
+            if(addr.is_unnamed() || addr.is_abstract())
+                return;
+
+            struct stat info{};
+            if(lstat(addr.path().c_str(), &info) == -1 || !S_ISSOCK(info.st_mode))
+                return;
+
+            try
+            {
+                UnixStreamSocket probe(type);
+                probe.connect(addr);
+            }
+            catch(MethodError& e)
+            {
+                if(e.error_code == ECONNREFUSED)
+                    unlink(addr.path().c_str());
+            }
+        }
+    }
+
+    UnixServerSocket::UnixServerSocket(const abl::LocalAddress& addr, int backlog, abl::sock_type type) :
+    _serverSocket(type)
+    {
+        remove_stale_socket(addr, type);
+
+        _serverSocket.bind(addr);
+        _serverSocket.listen(backlog);
+    }
+
+    UnixConnection UnixServerSocket::accept() const
+    {
+        return UnixConnection(_serverSocket.accept());
+    }
+
+    const UnixStreamSocket& UnixServerSocket::get_socket() const
+    {
+        return _serverSocket;
+    }
+}
@@ -0,0 +1,266 @@
+//
+// Implementation of UnixStreamSocket.
+//
+
+#include <sockets/UnixStreamSocket.h>
+#include <sockets/Error.h>
+#include <sockets/abl/stream.h>
+#include <sockets/abl/system.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <cstring>
+
+namespace sockets
+{
+    using namespace abl;
+
+    const size_t UnixStreamSocket::MAX_VECTORS;
+    const size_t UnixStreamSocket::MAX_HANDLES;
+
+    UnixStreamSocket::UnixStreamSocket() : handle() {}
+
+    UnixStreamSocket::UnixStreamSocket(abl::SocketHandle&& handle) : handle(std::move(handle)) {}
+
+    UnixStreamSocket::UnixStreamSocket(abl::sock_type type, bool nonblocking) :
+    handle(abl::new_socket_handle(ip_family::LOCAL, type, sock_proto::DEFAULT, nonblocking)) {}
+
+    std::tuple<UnixStreamSocket, UnixStreamSocket> UnixStreamSocket::pair(abl::sock_type type)
+    {
+        int sys_type = system::sttosys(type);
+#ifdef SOCK_CLOEXEC
+        sys_type |= SOCK_CLOEXEC;
+#endif
+
+        int descriptors[2];
+        if(::socketpair(AF_UNIX, sys_type, 0, descriptors) == -1)
+            throw MethodError("UnixStreamSocket::pair", "socketpair");
+
+        auto rv = std::make_tuple(UnixStreamSocket(system::socket_from_system_handle(descriptors[0])),
+                                  UnixStreamSocket(system::socket_from_system_handle(descriptors[1])));
+#ifndef SOCK_CLOEXEC
+        ::fcntl(descriptors[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(descriptors[1], F_SETFD, FD_CLOEXEC);
+#endif
+        return rv;
+    }
+
+    bool UnixStreamSocket::operator==(UnixStreamSocket& other)
+    {
+        return this->handle == other.handle;
+    }
+
+    bool UnixStreamSocket::invalid() const
+    {
+        return !this->handle;
+    }
+
+    void UnixStreamSocket::set_nonblocking(bool nonblocking)
+    {
+        abl::set_nonblocking(this->handle, nonblocking);
+    }
+
+    UnixStreamSocket UnixStreamSocket::accept() const
+    {
+        int result = accept_handle(this->handle, nullptr, nullptr, false);
+        if(result == INVALID_NATIVE_HANDLE)
+            throw MethodError("UnixStreamSocket::accept", "accept");
+        return UnixStreamSocket(system::socket_from_system_handle(result));
+    }
+
+    void UnixStreamSocket::bind(const LocalAddress& addr)
+    {
+        sockaddr_storage storage{};
+        socklen_t length = system::from_localaddress(addr, storage);
+
+        if(::bind(system::get_system_handle(this->handle), reinterpret_cast<sockaddr*>(&storage), length) == -1)
+            throw MethodError("UnixStreamSocket::bind", "bind");
+    }
+
+    void UnixStreamSocket::connect(const LocalAddress& addr)
+    {
+        sockaddr_storage storage{};
+        socklen_t length = system::from_localaddress(addr, storage);
+
+        if(::connect(system::get_system_handle(this->handle), reinterpret_cast<sockaddr*>(&storage), length) == -1)
+            throw MethodError("UnixStreamSocket::connect", "connect");
+    }
+
+    void UnixStreamSocket::listen(int backlog)
+    {
+        if(::listen(system::get_system_handle(this->handle), backlog) == -1)
+            throw MethodError("UnixStreamSocket::listen", "listen");
+    }
+
+    LocalAddress UnixStreamSocket::getpeername() const
+    {
+        sockaddr_storage storage{};
+        socklen_t length = sizeof(storage);
+
+        if(::getpeername(system::get_system_handle(this->handle), reinterpret_cast<sockaddr*>(&storage), &length) == -1)
+            throw MethodError("UnixStreamSocket::getpeername", "getpeername");
+
+        return system::to_localaddress(storage, length);
+    }
+
+    LocalAddress UnixStreamSocket::getsockname() const
+    {
+        sockaddr_storage storage{};
+        socklen_t length = sizeof(storage);
+
+        if(::getsockname(system::get_system_handle(this->handle), reinterpret_cast<sockaddr*>(&storage), &length) == -1)
+            throw MethodError("UnixStreamSocket::getsockname", "getsockname");
+
+        return system::to_localaddress(storage, length);
+    }
+
+    size_t UnixStreamSocket::recv(ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        return stream_recv(this->handle, buffer, amount, offset, flags, "UnixStreamSocket::recv");
+    }
+
+    size_t UnixStreamSocket::send(const ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        return send(buffer.data() + offset, amount, flags);
+    }
+
+    size_t UnixStreamSocket::send(const byte* data, size_t amount, int flags) const
+    {
+        return stream_send(this->handle, data, amount, flags, "UnixStreamSocket::send");
+    }
+
+    size_t UnixStreamSocket::sendv(const ConstByteView* views, size_t count, int flags) const
+    {
+        return stream_sendv(this->handle, views, count, flags, "UnixStreamSocket::sendv");
+    }
+
+    size_t UnixStreamSocket::sendv(std::initializer_list<ConstByteView> views, int flags) const
+    {
+        return sendv(views.begin(), views.size(), flags);
+    }
+
+    size_t UnixStreamSocket::recvv(const ByteView* views, size_t count, int flags) const
+    {
+        return stream_recvv(this->handle, views, count, flags, "UnixStreamSocket::recvv");
+    }
+
+    size_t UnixStreamSocket::recvv(std::initializer_list<ByteView> views, int flags) const
+    {
+        return recvv(views.begin(), views.size(), flags);
+    }
+
+    size_t UnixStreamSocket::send_handles(const native_handle_t* handles, size_t count, ConstByteView data,
+                                          int flags) const
+    {
+        if(data.size == 0)
+            throw std::invalid_argument("UnixStreamSocket::send_handles: at least one byte must be sent");
+
+        count = std::min(count, MAX_HANDLES);
+
+        iovec buffer{const_cast<byte*>(data.data), data.size};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_HANDLES)] = {};
+
+        msghdr message{};
+        message.msg_iov = &buffer;
+        message.msg_iovlen = 1;
+
+        if(count > 0)
+        {
+            message.msg_control = control;
+            message.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+            std::memcpy(CMSG_DATA(cmsg), handles, sizeof(int) * count);
+        }
+
+        ssize_t result = ::sendmsg(system::get_system_handle(this->handle), &message, flags);
+        if(result == -1)
+            throw SocketWriteError("UnixStreamSocket::send_handles");
+
+        return static_cast<size_t>(result);
+    }
+
+    size_t UnixStreamSocket::send_handles(std::initializer_list<std::reference_wrapper<const SocketHandle>> handles,
+                                          ConstByteView data, int flags) const
+    {
+        native_handle_t natives[MAX_HANDLES];
+        size_t count = std::min(handles.size(), MAX_HANDLES);
+
+        auto it = handles.begin();
+        for(size_t i = 0; i < count; ++i, ++it)
+            natives[i] = system::get_system_handle(it->get());
+
+        return send_handles(natives, count, data, flags);
+    }
+
+    std::tuple<size_t, std::vector<SocketHandle>>
+    UnixStreamSocket::recv_handles(ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        buffer.resize(amount + offset);
+
+        iovec vector{buffer.data() + offset, amount};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_HANDLES)];
+
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+#ifdef MSG_CMSG_CLOEXEC
+        flags |= MSG_CMSG_CLOEXEC;
+#endif
+
+        ssize_t result = ::recvmsg(system::get_system_handle(this->handle), &message, flags);
+        if(result == -1)
+        {
+            buffer.resize(offset);
+            throw SocketReadError("UnixStreamSocket::recv_handles");
+        }
+
+        std::vector<SocketHandle> handles;
+        for(cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+        {
+            if(cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+                continue;
+
+            size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for(size_t i = 0; i < count; ++i)
+            {
+                int descriptor;
+                std::memcpy(&descriptor, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+                handles.emplace_back(descriptor);
+            }
+        }
+
+        buffer.resize(static_cast<size_t>(result) + offset);
+        return std::make_tuple(static_cast<size_t>(result), std::move(handles));
+    }
+
+    IoResult UnixStreamSocket::try_recv(ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        return stream_try_recv(this->handle, buffer, amount, offset, flags, "UnixStreamSocket::try_recv");
+    }
+
+    IoResult UnixStreamSocket::try_send(const ByteBuffer& buffer, size_t amount, size_t offset, int flags) const
+    {
+        return try_send(buffer.data() + offset, amount, flags);
+    }
+
+    IoResult UnixStreamSocket::try_send(const byte* data, size_t amount, int flags) const
+    {
+        return stream_try_send(this->handle, data, amount, flags, "UnixStreamSocket::try_send");
+    }
+
+    UnixConnection connect_local(const LocalAddress& path, abl::sock_type type)
+    {
+        UnixStreamSocket s(type);
+        s.connect(path);
+
+        return UnixConnection(std::move(s));
+    }
+}
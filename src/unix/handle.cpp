@@ -6,6 +6,11 @@
 #include <sockets/abl/system.h>
 #include <sockets/Error.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <vector>
 
 namespace sockets {
     namespace abl {
@@ -20,24 +25,123 @@ namespace sockets {
             handle->socket = 0;
         }
 
-        UniqueHandle new_unique_handle(ip_family family, sock_type type, sock_proto protocol)
+        void close_native_handle(native_handle_t handle)
         {
-            int s = socket(system::iftosys(family), system::sttosys(type), system::sptosys(protocol));
+            close(handle);
+        }
+
+        SocketHandle::SocketHandle(UniqueHandle&& handle) : _handle(INVALID_NATIVE_HANDLE)
+        {
+            if(handle != nullptr)
+            {
+                _handle = handle->socket;
+                delete handle.release();
+            }
+        }
+
+        namespace
+        {
+            void set_descriptor_nonblocking(int s, bool nonblocking)
+            {
+                int flags = fcntl(s, F_GETFL, 0);
+                if(flags == -1)
+                    throw MethodError("set_nonblocking", "fcntl");
+
+                flags = nonblocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+                if(fcntl(s, F_SETFL, flags) == -1)
+                    throw MethodError("set_nonblocking", "fcntl");
+            }
+
+            int new_socket(ip_family family, sock_type type, sock_proto protocol, bool nonblocking)
+            {
+                int sys_type = system::sttosys(type);
+#ifdef SOCK_NONBLOCK
+                if(nonblocking)
+                    sys_type |= SOCK_NONBLOCK;
+#endif
+
+                int s = socket(system::iftosys(family), sys_type, system::sptosys(protocol));
+
+                if(s == -1)
+                    throw MethodError("new_socket", "socket");
+
+#ifndef SOCK_NONBLOCK
+                if(nonblocking)
+                {
+                    SocketHandle guard(s);
+                    set_descriptor_nonblocking(s, true);
+                    guard.release();
+                }
+#endif
+                return s;
+            }
+        }
+
+        UniqueHandle new_unique_handle(ip_family family, sock_type type, sock_proto protocol, bool nonblocking)
+        {
+            return UniqueHandle(new handle_t{new_socket(family, type, protocol, nonblocking)}, &close_handle);
+        }
 
-            if(s == -1)
-                throw MethodError(__func__, "socket");
+        SharedHandle new_shared_handle(ip_family family, sock_type type, sock_proto protocol, bool nonblocking)
+        {
+            return SharedHandle(new handle_t{new_socket(family, type, protocol, nonblocking)}, &close_handle);
+        }
+
+        SocketHandle new_socket_handle(ip_family family, sock_type type, sock_proto protocol, bool nonblocking)
+        {
+            return SocketHandle(new_socket(family, type, protocol, nonblocking));
+        }
+
+        void set_nonblocking(HandleRef handle, bool nonblocking)
+        {
+            set_descriptor_nonblocking(system::get_system_handle(handle), nonblocking);
+        }
 
-            return UniqueHandle(new handle_t{s}, &close_handle);
+        void set_nonblocking(const SocketHandle& handle, bool nonblocking)
+        {
+            set_descriptor_nonblocking(system::get_system_handle(handle), nonblocking);
+        }
+
+        bool is_nonblocking(const SocketHandle& handle)
+        {
+            int flags = fcntl(system::get_system_handle(handle), F_GETFL, 0);
+            if(flags == -1)
+                throw MethodError("is_nonblocking", "fcntl");
+            return (flags & O_NONBLOCK) != 0;
         }
 
-        SharedHandle new_shared_handle(ip_family family, sock_type type, sock_proto protocol)
+        size_t poll_handles(PollEntry* entries, size_t count, int timeout_ms)
         {
-            int s = socket(system::iftosys(family), system::sttosys(type), system::sptosys(protocol));
+            std::vector<pollfd> descriptors(count);
+            for(size_t i = 0; i < count; ++i)
+            {
+                descriptors[i].fd = system::get_system_handle(*entries[i].handle);
+                descriptors[i].events = static_cast<short>(((entries[i].events & poll_event::READABLE) ? POLLIN : 0) |
+                                                           ((entries[i].events & poll_event::WRITABLE) ? POLLOUT : 0));
+            }
 
-            if(s == -1)
-                throw MethodError(__func__, "socket");
+            int result = ::poll(descriptors.data(), static_cast<nfds_t>(count), timeout_ms);
+            if(result == -1)
+            {
+                if(errno == EINTR)
+                    return 0;
+                throw MethodError("poll_handles", "poll");
+            }
 
-            return SharedHandle(new handle_t{s}, &close_handle);
+            for(size_t i = 0; i < count; ++i)
+            {
+                short revents = descriptors[i].revents;
+                entries[i].ready = ((revents & POLLIN) ? poll_event::READABLE : 0) |
+                                   ((revents & POLLOUT) ? poll_event::WRITABLE : 0) |
+                                   ((revents & (POLLERR | POLLHUP | POLLNVAL)) ? poll_event::FAILED : 0);
+            }
+
+            return static_cast<size_t>(result);
+        }
+
+        int nonblocking_io_flag()
+        {
+            return MSG_DONTWAIT;
         }
 
         int system::get_system_handle(HandleRef handle)
@@ -4,7 +4,10 @@
 
 #include <sockets/abl/system.h>
 #include <sockets/Error.h>
+#include <cstring>
 #include <arpa/inet.h>
+#include <sys/un.h>
+#include <cstddef>
 
 namespace sockets {
     namespace abl {
@@ -15,6 +18,7 @@ namespace sockets {
                 case ANY: return AF_UNSPEC;
                 case INET: return AF_INET;
                 case INET6: return AF_INET6;
+                case LOCAL: return AF_UNIX;
             }
 
             return -1;
@@ -27,6 +31,8 @@ namespace sockets {
                     return ip_family::INET;
                 case AF_INET6:
                     return ip_family::INET6;
+                case AF_UNIX:
+                    return ip_family::LOCAL;
                 default:
                     return ip_family::ANY;
             }
@@ -41,6 +47,8 @@ namespace sockets {
                     return SOCK_DGRAM;
                 case sock_type::RAW:
                     return SOCK_RAW;
+                case sock_type::SEQPACKET:
+                    return SOCK_SEQPACKET;
             }
             return -1;
         }
@@ -52,6 +60,8 @@ namespace sockets {
                     return sock_type::STREAM;
                 case SOCK_DGRAM:
                     return sock_type::DATAGRAM;
+                case SOCK_SEQPACKET:
+                    return sock_type::SEQPACKET;
                 default:
                     return sock_type::RAW;
             }
@@ -64,6 +74,8 @@ namespace sockets {
                     return IPPROTO_TCP;
                 case sock_proto::UDP:
                     return IPPROTO_UDP;
+                case sock_proto::DEFAULT:
+                    return 0;
             }
             return -1;
         }
@@ -75,6 +87,8 @@ namespace sockets {
                     return sock_proto::TCP;
                 case IPPROTO_UDP:
                     return sock_proto::UDP;
+                case 0:
+                    return sock_proto::DEFAULT;
                 default:
                     throw std::invalid_argument("proto");
             }
@@ -123,6 +137,58 @@ namespace sockets {
             throw std::invalid_argument("to_ipaddress: addr does not contain an ipv4 or ipv6 address");
         }
 
+        socklen_t system::from_ipaddress(const IpAddress &address, sockaddr_storage &storage)
+        {
+            if(address.is_ipv4())
+            {
+                auto addr = from_ipv4(address.get_as_ipv4());
+                std::memcpy(&storage, &addr, sizeof(addr));
+                return sizeof(addr);
+            }
+
+            if(address.is_ipv6())
+            {
+                auto addr = from_ipv6(address.get_as_ipv6());
+                std::memcpy(&storage, &addr, sizeof(addr));
+                return sizeof(addr);
+            }
+
+            return 0;
+        }
+
+        socklen_t system::from_localaddress(const LocalAddress &address, sockaddr_storage &storage)
+        {
+            const std::string& path = address.path();
+
+            sockaddr_un addr{};
+            // Paths need room for a null-terminator, abstract names do not.
+            if(path.size() + (address.is_abstract() ? 0 : 1) > sizeof(addr.sun_path))
+                throw std::invalid_argument("from_localaddress: path is too long for a local socket");
+
+            addr.sun_family = AF_UNIX;
+            std::copy(path.begin(), path.end(), addr.sun_path);
+            std::memcpy(&storage, &addr, sizeof(addr));
+
+            auto length = offsetof(sockaddr_un, sun_path) + path.size();
+            return static_cast<socklen_t>(address.is_abstract() ? length : length + 1);
+        }
+
+        LocalAddress system::to_localaddress(const sockaddr_storage &storage, socklen_t length)
+        {
+            const auto& addr = reinterpret_cast<const sockaddr_un&>(storage);
+            if(addr.sun_family != AF_UNIX)
+                throw std::invalid_argument("to_localaddress: storage does not contain a local address");
+
+            auto offset = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path));
+            if(length <= offset)
+                return LocalAddress();
+
+            size_t size = length - offset;
+            if(addr.sun_path[0] == '\0')
+                return LocalAddress(std::string(addr.sun_path, size));
+            return LocalAddress(std::string(addr.sun_path, strnlen(addr.sun_path, size)));
+        }
+
         sockaddr_in system::from_ipv4_str(const std::string &str, uint16_t port)
         {
             sockaddr_in rv{INET, htons(port), {}, {}};
@@ -23,6 +23,26 @@ std::string sockets::get_error_message(int code)
     return std::string(message);
 }
 
+bool sockets::check_would_block(int code)
+{
+    return code == WSAEWOULDBLOCK;
+}
+
+bool sockets::check_connection_aborted(int code)
+{
+    return code == WSAECONNRESET;
+}
+
+bool sockets::check_connect_in_progress(int code)
+{
+    return code == WSAEWOULDBLOCK;
+}
+
+int sockets::get_timed_out_code()
+{
+    return WSAETIMEDOUT;
+}
+
 sockets::SocketReadError::ErrorType sockets::SocketReadError::map_error_type(int code)
 {
     switch (code)
@@ -42,6 +62,26 @@ sockets::SocketReadError::ErrorType sockets::SocketReadError::map_error_type(int
     }
 }
 
+sockets::ConnectError::ErrorType sockets::ConnectError::map_error_type(int code)
+{
+    switch (code)
+    {
+        case WSAETIMEDOUT:
+            return ErrorType::TIMED_OUT;
+        case WSAECONNREFUSED:
+            return ErrorType::CONNECTION_REFUSED;
+        case WSAENETUNREACH:
+            return ErrorType::NETWORK_UNREACHABLE;
+        case WSAEHOSTUNREACH:
+            return ErrorType::HOST_UNREACHABLE;
+        case WSAEADDRINUSE:
+        case WSAEADDRNOTAVAIL:
+            return ErrorType::ADDRESS_IN_USE;
+        default:
+            return ErrorType::OTHER;
+    }
+}
+
 sockets::SocketWriteError::ErrorType sockets::SocketWriteError::map_error_type(int code)
 {
     switch (code)
@@ -5,6 +5,7 @@
 #include <sockets/Error.h>
 #include <sockets/abl/handle.h>
 #include <sockets/abl/system.h>
+#include <vector>
 
 namespace sockets {
     namespace abl {
@@ -18,6 +19,20 @@ namespace sockets {
             closesocket(handle->socket);
         }
 
+        void close_native_handle(native_handle_t handle)
+        {
+            closesocket(static_cast<SOCKET>(handle));
+        }
+
+        SocketHandle::SocketHandle(UniqueHandle&& handle) : _handle(INVALID_NATIVE_HANDLE)
+        {
+            if(handle != nullptr)
+            {
+                _handle = static_cast<native_handle_t>(handle->socket);
+                delete handle.release();
+            }
+        }
+
         SOCKET system::get_system_handle(const handle_t* handle)
         {
             if(handle != nullptr)
@@ -54,24 +69,99 @@ namespace sockets {
             return SharedHandle(new handle_t{handle}, &close_handle);
         }
 
-        UniqueHandle new_unique_handle(ip_family family, sock_type type, sock_proto protocol)
+        UniqueHandle new_unique_handle(ip_family family, sock_type type, sock_proto protocol, bool nonblocking)
+        {
+            SOCKET s = socket(system::iftosys(family), system::sttosys(type), system::sptosys(protocol));
+
+            if(s == INVALID_SOCKET)
+                throw MethodError(__func__, "socket");
+
+            UniqueHandle rv(new handle_t{s}, &close_handle);
+            if(nonblocking)
+                set_nonblocking(rv.get(), true);
+            return rv;
+        }
+
+        SharedHandle new_shared_handle(ip_family family, sock_type type, sock_proto protocol, bool nonblocking)
         {
             SOCKET s = socket(system::iftosys(family), system::sttosys(type), system::sptosys(protocol));
 
             if(s == INVALID_SOCKET)
                 throw MethodError(__func__, "socket");
 
-            return UniqueHandle(new handle_t{s}, &close_handle);
+            SharedHandle rv(new handle_t{s}, &close_handle);
+            if(nonblocking)
+                set_nonblocking(rv.get(), true);
+            return rv;
         }
 
-        SharedHandle new_shared_handle(ip_family family, sock_type type, sock_proto protocol)
+        SocketHandle new_socket_handle(ip_family family, sock_type type, sock_proto protocol, bool nonblocking)
         {
             SOCKET s = socket(system::iftosys(family), system::sttosys(type), system::sptosys(protocol));
 
             if(s == INVALID_SOCKET)
                 throw MethodError(__func__, "socket");
 
-            return SharedHandle(new handle_t{s}, &close_handle);
+            SocketHandle rv(static_cast<native_handle_t>(s));
+            if(nonblocking)
+                set_nonblocking(rv, true);
+            return rv;
+        }
+
+        namespace
+        {
+            void set_socket_nonblocking(SOCKET s, bool nonblocking)
+            {
+                u_long mode = nonblocking ? 1 : 0;
+                if(ioctlsocket(s, FIONBIO, &mode) == SOCKET_ERROR)
+                    throw MethodError("set_nonblocking", "ioctlsocket");
+            }
+        }
+
+        void set_nonblocking(HandleRef handle, bool nonblocking)
+        {
+            set_socket_nonblocking(system::get_system_handle(handle), nonblocking);
+        }
+
+        void set_nonblocking(const SocketHandle& handle, bool nonblocking)
+        {
+            set_socket_nonblocking(system::get_system_handle(handle), nonblocking);
+        }
+
+        bool is_nonblocking(const SocketHandle&)
+        {
+            // Winsock has no way to query FIONBIO
+            return false;
+        }
+
+        size_t poll_handles(PollEntry* entries, size_t count, int timeout_ms)
+        {
+            std::vector<WSAPOLLFD> descriptors(count);
+            for(size_t i = 0; i < count; ++i)
+            {
+                descriptors[i].fd = system::get_system_handle(*entries[i].handle);
+                descriptors[i].events = static_cast<SHORT>(((entries[i].events & poll_event::READABLE) ? POLLRDNORM : 0) |
+                                                           ((entries[i].events & poll_event::WRITABLE) ? POLLWRNORM : 0));
+            }
+
+            int result = WSAPoll(descriptors.data(), static_cast<ULONG>(count), timeout_ms);
+            if(result == SOCKET_ERROR)
+                throw MethodError("poll_handles", "WSAPoll");
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                SHORT revents = descriptors[i].revents;
+                entries[i].ready = ((revents & POLLRDNORM) ? poll_event::READABLE : 0) |
+                                   ((revents & POLLWRNORM) ? poll_event::WRITABLE : 0) |
+                                   ((revents & (POLLERR | POLLHUP | POLLNVAL)) ? poll_event::FAILED : 0);
+            }
+
+            return static_cast<size_t>(result);
+        }
+
+        int nonblocking_io_flag()
+        {
+            return 0;
         }
     }
 }
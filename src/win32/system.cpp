@@ -5,6 +5,7 @@
 #include <sockets/abl/system.h>
 #include <in6addr.h>
 #include <sockets/Error.h>
+#include <cstring>
 #include <inaddr.h>
 
 std::vector<char> c_str_copy(const std::string& str)
@@ -27,6 +28,8 @@ namespace sockets {
                     return AF_INET6;
                 case ip_family::ANY:
                     return AF_UNSPEC;
+                case ip_family::LOCAL:
+                    return AF_UNIX;
             }
             return -1;
         }
@@ -38,6 +41,8 @@ namespace sockets {
                     return ip_family::INET;
                 case AF_INET6:
                     return ip_family::INET6;
+                case AF_UNIX:
+                    return ip_family::LOCAL;
                 default:
                     return ip_family::ANY;
             }
@@ -52,6 +57,8 @@ namespace sockets {
                     return SOCK_DGRAM;
                 case sock_type::RAW:
                     return SOCK_RAW;
+                case sock_type::SEQPACKET:
+                    return SOCK_SEQPACKET;
             }
             return -1;
         }
@@ -63,6 +70,8 @@ namespace sockets {
                     return sock_type::STREAM;
                 case SOCK_DGRAM:
                     return sock_type::DATAGRAM;
+                case SOCK_SEQPACKET:
+                    return sock_type::SEQPACKET;
                 default:
                     return sock_type::RAW;
             }
@@ -75,6 +84,8 @@ namespace sockets {
                     return IPPROTO_TCP;
                 case sock_proto::UDP:
                     return IPPROTO_UDP;
+                case sock_proto::DEFAULT:
+                    return 0;
             }
             return -1;
         }
@@ -86,6 +97,8 @@ namespace sockets {
                     return sock_proto::TCP;
                 case IPPROTO_UDP:
                     return sock_proto::UDP;
+                case 0:
+                    return sock_proto::DEFAULT;
                 default:
                     throw std::invalid_argument("proto");
             }
@@ -142,6 +155,25 @@ namespace sockets {
             throw std::invalid_argument("addr->sa_family is not set to AF_INET or AF_INET6");
         }
 
+        socklen_t system::from_ipaddress(const IpAddress &address, sockaddr_storage &storage)
+        {
+            if(address.is_ipv4())
+            {
+                auto addr = from_ipv4(address.get_as_ipv4());
+                std::memcpy(&storage, &addr, sizeof(addr));
+                return sizeof(addr);
+            }
+
+            if(address.is_ipv6())
+            {
+                auto addr = from_ipv6(address.get_as_ipv6());
+                std::memcpy(&storage, &addr, sizeof(addr));
+                return sizeof(addr);
+            }
+
+            return 0;
+        }
+
         sockaddr_in system::from_ipv4_str(const std::string &str, uint16_t port)
         {
             // Copy the string into a vector because std::string doesn't provide a non-const pointer
@@ -0,0 +1,83 @@
+//
+// Tests that accept_batch() drains every pending connection from a non-blocking listener, and that accepted sockets
+// are non-blocking and close-on-exec. Also tests that TCPServerSocket::accept_batch() applies the accepted options.
+//
+
+#include <sockets/Connection.h>
+#include <sockets/TCPServerSocket.h>
+#include <sockets/TCPSocket.h>
+#include <sockets/abl/system.h>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using sockets::TCPConnection;
+using sockets::TCPServerSocket;
+using sockets::TCPSocket;
+using sockets::abl::IpAddress;
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    static const size_t CLIENT_COUNT = 20;
+
+    try
+    {
+        TCPSocket listener(sockets::abl::INET);
+        listener.bind(IpAddress(sockets::abl::INET, "127.0.0.1", 0));
+        listener.listen(64);
+        listener.set_nonblocking(true);
+        auto port = std::to_string(ntohs(listener.getsockname().port()));
+
+        std::vector<TCPConnection> clients;
+        for (size_t i = 0; i < CLIENT_COUNT; ++i)
+            clients.push_back(sockets::connect_to("127.0.0.1", port));
+
+        auto first = listener.accept_batch(CLIENT_COUNT / 2);
+        auto rest = listener.accept_batch(CLIENT_COUNT * 2);
+        auto empty = listener.accept_batch(CLIENT_COUNT);
+        cout << "Accepted " << first.size() << " + " << rest.size() << " + " << empty.size() << endl;
+
+        bool ok = first.size() == CLIENT_COUNT / 2 && rest.size() == CLIENT_COUNT / 2 && empty.empty();
+
+        for (auto& accepted : first)
+        {
+            int descriptor = sockets::abl::system::get_system_handle(std::get<0>(accepted).handle);
+            ok = ok && (fcntl(descriptor, F_GETFL) & O_NONBLOCK) != 0 && (fcntl(descriptor, F_GETFD) & FD_CLOEXEC) != 0;
+            ok = ok && std::get<1>(accepted).is_loopback();
+        }
+
+        ByteBuffer buffer;
+        ok = ok && std::get<0>(rest[0]).try_recv(buffer, 16).would_block();
+
+        TCPServerSocket server(IpAddress(sockets::abl::INET, "127.0.0.1", 0), sockets::ListenOptions());
+        server.set_nonblocking(true);
+        server.set_accepted_option(sockets::options::Linger{true, std::chrono::seconds(2)});
+        auto server_port = std::to_string(ntohs(server.get_socket().getsockname().port()));
+
+        std::vector<TCPConnection> server_clients;
+        for (size_t i = 0; i < CLIENT_COUNT; ++i)
+            server_clients.push_back(sockets::connect_to("127.0.0.1", server_port));
+
+        auto connections = server.accept_batch(CLIENT_COUNT * 2);
+        cout << "Server accepted " << connections.size() << endl;
+        ok = ok && connections.size() == CLIENT_COUNT;
+
+        for (auto& accepted : connections)
+        {
+            auto linger = std::get<0>(accepted).get_socket().get_option<sockets::options::Linger>();
+            ok = ok && linger.enabled && linger.timeout == std::chrono::seconds(2);
+        }
+
+        cout << (ok ? "Success!" : "Fail.") << endl;
+        return ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
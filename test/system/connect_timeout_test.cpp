@@ -0,0 +1,86 @@
+//
+// Tests that a connection with a timeout succeeds against a listening server, and that it fails with
+// ConnectError::TIMED_OUT against a server whose listen queue is full, which silently drops new connections. The
+// socket keeps its blocking mode either way.
+//
+
+#include <sockets/Connection.h>
+#include <sockets/Error.h>
+#include <sockets/TCPSocket.h>
+#include <sockets/abl/system.h>
+#include <chrono>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using sockets::ConnectError;
+using sockets::TCPSocket;
+using sockets::abl::IpAddress;
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    static const std::chrono::milliseconds TIMEOUT(200);
+
+    try
+    {
+        TCPSocket listener(sockets::abl::INET);
+        listener.bind(IpAddress(sockets::abl::INET, "127.0.0.1", 0));
+        listener.listen(0);
+        auto address = listener.getsockname();
+        auto port = std::to_string(ntohs(address.port()));
+
+        // Fills the listen queue, which is never drained
+        TCPSocket first(sockets::abl::INET);
+        first.connect(address, TIMEOUT);
+        int descriptor = sockets::abl::system::get_system_handle(first.handle);
+        bool ok = (fcntl(descriptor, F_GETFL) & O_NONBLOCK) == 0;
+
+        bool timed_out = false;
+        std::vector<sockets::TCPConnection> clients;
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            for (int i = 0; i < 4; ++i)
+                clients.push_back(sockets::connect_to("127.0.0.1", port, TIMEOUT));
+        }
+        catch (ConnectError& e)
+        {
+            timed_out = e.type == ConnectError::TIMED_OUT;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        cout << "Connected " << clients.size() << " before timing out" << endl;
+        ok = ok && timed_out && elapsed < TIMEOUT * (clients.size() + 1) + std::chrono::milliseconds(500);
+
+        // A socket keeps its mode when the connection times out, whichever mode it was in
+        bool modes_kept = true;
+        for (bool nonblocking : {false, true})
+        {
+            TCPSocket late(sockets::abl::INET, nonblocking);
+            try
+            {
+                late.connect(address, TIMEOUT);
+            }
+            catch (ConnectError&)
+            {
+            }
+
+            int flags = fcntl(sockets::abl::system::get_system_handle(late.handle), F_GETFL);
+            modes_kept = modes_kept && ((flags & O_NONBLOCK) != 0) == nonblocking;
+        }
+        cout << "Mode kept: " << modes_kept << endl;
+        ok = ok && modes_kept;
+
+        cout << (ok ? "Success!" : "Fail.") << endl;
+        return ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,94 @@
+//
+// Tests that Connection reads and writes fail with TIMED_OUT once their deadline expires, for both per-connection
+// and per-call timeouts, and that data arriving in time is still read.
+//
+
+#include <sockets/Connection.h>
+#include <sockets/Error.h>
+#include <sockets/TCPServerSocket.h>
+#include <sockets/abl/system.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using sockets::SocketReadError;
+using sockets::SocketWriteError;
+using sockets::TCPServerSocket;
+using sockets::abl::IpAddress;
+
+using std::cout;
+using std::endl;
+
+namespace
+{
+    const std::chrono::milliseconds TIMEOUT(100);
+
+    template<typename Fn>
+    bool read_times_out(Fn fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            fn();
+        }
+        catch (SocketReadError& e)
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            return e.type == SocketReadError::TIMED_OUT && elapsed >= TIMEOUT && elapsed < TIMEOUT * 10;
+        }
+        return false;
+    }
+}
+
+int main()
+{
+    try
+    {
+        TCPServerSocket server(IpAddress(sockets::abl::INET, "127.0.0.1", 0));
+        auto port = std::to_string(ntohs(server.get_socket().getsockname().port()));
+
+        auto client = sockets::connect_to("127.0.0.1", port);
+        auto peer = server.accept();
+
+        // The peer sends nothing, so a read can only end by timing out
+        peer.set_read_timeout(TIMEOUT);
+        bool ok = read_times_out([&]() { peer.read_exactly(10); });
+        cout << "Connection read timeout: " << ok << endl;
+
+        // Only part of the message arrives before the per-call deadline
+        peer.set_read_timeout(std::chrono::milliseconds(0));
+        client.write_all(std::string("GET /"));
+        bool partial = read_times_out([&]() { peer.read_until(ByteString<2>{'\r', '\n'}, TIMEOUT); });
+        cout << "Call read timeout: " << partial << endl;
+
+        // The rest arrives in time, and is returned together with the part received before the timeout
+        client.write_all(std::string(" HTTP/1.1\r\n"));
+        auto& line = peer.read_until(ByteString<2>{'\r', '\n'}, TIMEOUT);
+        bool in_time = std::string(line.begin(), line.end()) == "GET / HTTP/1.1\r\n";
+        cout << "Read in time: " << in_time << endl;
+
+        // The client never reads, so the send buffers eventually fill up
+        peer.set_write_timeout(TIMEOUT);
+        bool write_timed_out = false;
+        try
+        {
+            std::string chunk(1 << 20, 'x');
+            for (int i = 0; i < 256; ++i)
+                peer.write_all(chunk);
+        }
+        catch (SocketWriteError& e)
+        {
+            write_timed_out = e.type == SocketWriteError::TIMED_OUT;
+        }
+        cout << "Write timeout: " << write_timed_out << endl;
+
+        ok = ok && partial && in_time && write_timed_out;
+        cout << (ok ? "Success!" : "Fail.") << endl;
+        return ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
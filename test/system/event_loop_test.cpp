@@ -0,0 +1,131 @@
+//
+// Tests that a single EventLoop can serve several connections on one thread over loopback, and that a callback
+// that throws does not drop the other events of its batch.
+//
+
+#include <sockets/EventLoop.h>
+#include <sockets/TCPServerSocket.h>
+#include <sockets/abl/system.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using sockets::EventLoop;
+using sockets::TCPConnection;
+using sockets::TCPServerSocket;
+using sockets::UnixStreamSocket;
+
+using std::cout;
+using std::endl;
+
+namespace
+{
+    /**
+     * Registers two readable sockets whose callbacks both throw, and checks that one poll() runs both before it
+     * rethrows, and that both callbacks stay registered.
+     */
+    bool throwing_callbacks_keep_the_batch()
+    {
+        EventLoop loop;
+        auto first = UnixStreamSocket::pair();
+        auto second = UnixStreamSocket::pair();
+
+        int calls = 0;
+        auto callback = [&calls](unsigned int)
+        {
+            ++calls;
+            throw std::runtime_error("callback failed");
+        };
+        loop.add(std::get<0>(first), EventLoop::READABLE, callback);
+        loop.add(std::get<0>(second), EventLoop::READABLE, callback);
+
+        const byte ping = 'p';
+        std::get<1>(first).send(&ping, 1);
+        std::get<1>(second).send(&ping, 1);
+
+        for (int round = 1; round <= 2; ++round)
+        {
+            try
+            {
+                loop.poll(1000);
+                return false;
+            }
+            catch (std::runtime_error&) {}
+
+            if (calls != 2 * round)
+                return false;
+        }
+
+        return true;
+    }
+}
+
+int main()
+{
+    static const size_t CLIENT_COUNT = 8;
+    const std::string message = "ping";
+
+    try
+    {
+        TCPServerSocket server("127.0.0.1", "0");
+        auto port = std::to_string(ntohs(server.get_socket().getsockname().port()));
+        cout << "Listening on port " << port << "..." << endl;
+
+        EventLoop loop;
+        std::vector<std::unique_ptr<TCPConnection>> accepted;
+        size_t echoed = 0;
+
+        loop.add(server, [&](unsigned int)
+        {
+            accepted.emplace_back(new TCPConnection(server.accept()));
+            TCPConnection& conn = *accepted.back();
+
+            loop.add(conn, EventLoop::READABLE, [&](unsigned int events)
+            {
+                if (events & EventLoop::HANGUP)
+                {
+                    loop.remove(conn);
+                    return;
+                }
+
+                auto& data = conn.read(128);
+                conn.write(data.begin(), data.end());
+                if (++echoed == CLIENT_COUNT) loop.stop();
+            });
+        });
+
+        std::vector<TCPConnection> clients;
+        for (size_t i = 0; i < CLIENT_COUNT; ++i)
+        {
+            clients.push_back(sockets::connect_to("127.0.0.1", port));
+            clients.back().write(message.begin(), message.end());
+        }
+
+        loop.run();
+
+        for (auto& client : clients)
+        {
+            auto& response = client.read_exactly(message.size());
+            if (!std::equal(response.begin(), response.end(), message.begin(), message.end()))
+            {
+                cout << "Fail." << endl;
+                return 1;
+            }
+        }
+
+        cout << "Served " << accepted.size() << " connections on one thread." << endl;
+
+        bool batch_ok = throwing_callbacks_keep_the_batch();
+        cout << "Throwing callbacks: " << (batch_ok ? "ok" : "failed") << endl;
+
+        cout << (batch_ok ? "Success!" : "Fail.") << endl;
+        return batch_ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,72 @@
+//
+// Tests that connect_to() delivers its initial data to a TCPServerSocket with TCP Fast Open enabled, both for the
+// first connection, which fetches a cookie, and for later ones, which may carry the data in the SYN. Also tests that
+// a refused connection throws ConnectError.
+//
+
+#include <sockets/Error.h>
+#include <sockets/TCPServerSocket.h>
+#include <sockets/abl/system.h>
+#include <iostream>
+#include <string>
+
+using sockets::TCPServerSocket;
+using sockets::abl::IpAddress;
+
+namespace options = sockets::options;
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    try
+    {
+        sockets::ListenOptions listen_options;
+        listen_options.fastopen_queue = 16;
+        TCPServerSocket server(IpAddress(sockets::abl::INET, "127.0.0.1", 0), listen_options);
+        auto port = std::to_string(ntohs(server.get_socket().getsockname().port()));
+
+        bool ok = server.get_socket().get_option<options::FastOpen>().queue_length == 16;
+
+        const std::string request = "GET / HTTP/1.0\r\n\r\n";
+
+        for (int i = 0; i < 3; ++i)
+        {
+            auto client = sockets::connect_to("127.0.0.1", port, request);
+            auto peer = server.accept();
+
+            ByteBuffer buffer;
+            size_t received = 0;
+            while (received < request.size())
+                received += peer.get_socket().recv(buffer, request.size() - received, received);
+
+            ok = ok && std::string(buffer.begin(), buffer.end()) == request;
+        }
+
+        // A bound socket that is not listening refuses connections
+        sockets::TCPSocket closed(sockets::abl::INET);
+        closed.bind(IpAddress(sockets::abl::INET, "127.0.0.1", 0));
+
+        bool refused = false;
+        try
+        {
+            sockets::TCPSocket client(sockets::abl::INET);
+            client.connect_send(closed.getsockname(), reinterpret_cast<const byte*>(request.data()), request.size());
+        }
+        catch (sockets::ConnectError& e)
+        {
+            refused = e.type == sockets::ConnectError::CONNECTION_REFUSED;
+        }
+        cout << "Refused: " << refused << endl;
+        ok = ok && refused;
+
+        cout << (ok ? "Success!" : "Fail.") << endl;
+        return ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,74 @@
+//
+// Tests that a listening socket and a live connection can be handed over a local socket, and keep working after the
+// original owner has closed its copies.
+//
+
+#include <sockets/TCPServerSocket.h>
+#include <sockets/UnixStreamSocket.h>
+#include <sockets/abl/system.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using sockets::TCPConnection;
+using sockets::TCPServerSocket;
+using sockets::TCPSocket;
+using sockets::UnixStreamSocket;
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    const std::string message = "handoff";
+
+    try
+    {
+        UnixStreamSocket old_side, new_side;
+        std::tie(old_side, new_side) = UnixStreamSocket::pair();
+
+        std::unique_ptr<TCPServerSocket> server(new TCPServerSocket("127.0.0.1", "0"));
+        auto port = std::to_string(ntohs(server->get_socket().getsockname().port()));
+
+        // One client is established, the other waits in the listen queue during the handoff.
+        TCPConnection established = sockets::connect_to("127.0.0.1", port);
+        std::unique_ptr<TCPConnection> peer(new TCPConnection(server->accept()));
+        TCPConnection queued = sockets::connect_to("127.0.0.1", port);
+
+        old_side.send_handles({server->get_socket().handle, peer->get_socket().handle}, std::string("!"));
+        server.reset();
+        peer.reset();
+
+        ByteBuffer buffer;
+        size_t received;
+        std::vector<sockets::abl::SocketHandle> handles;
+        std::tie(received, handles) = new_side.recv_handles(buffer, 1);
+        if (received != 1 || handles.size() != 2)
+        {
+            cout << "Fail: received " << handles.size() << " handles." << endl;
+            return 1;
+        }
+
+        TCPServerSocket adopted(TCPSocket(std::move(handles[0])));
+        TCPConnection live(TCPSocket(std::move(handles[1])));
+
+        TCPConnection accepted = adopted.accept();
+        accepted.write_all(message);
+        live.write_all(message);
+
+        bool ok = true;
+        for (auto* conn : {&queued, &established})
+        {
+            auto& response = conn->read_exactly(message.size());
+            ok = ok && std::equal(response.begin(), response.end(), message.begin(), message.end());
+        }
+
+        cout << (ok ? "Success!" : "Fail.") << endl;
+        return ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
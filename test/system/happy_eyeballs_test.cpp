@@ -0,0 +1,57 @@
+//
+// Tests that connect_to() reaches a server listening on only one address family of a dual-stack name, and that it
+// reports a refused connection once every address has failed.
+//
+
+#include <sockets/TCPServerSocket.h>
+#include <sockets/Error.h>
+#include <sockets/abl/system.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using sockets::TCPServerSocket;
+using sockets::abl::IpAddress;
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    try
+    {
+        TCPServerSocket server(IpAddress(sockets::abl::INET, "127.0.0.1", 0));
+        auto port = std::to_string(ntohs(server.get_socket().getsockname().port()));
+
+        auto start = std::chrono::steady_clock::now();
+        auto client = sockets::connect_to("localhost", port);
+        auto peer = server.accept();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        bool ok = client.get_socket().getpeername().is_loopback() && elapsed < std::chrono::seconds(1);
+
+        // Nothing listens on the port once the server is closed
+        server = TCPServerSocket(IpAddress(sockets::abl::INET, "127.0.0.1", 0));
+        auto closed_port = std::to_string(ntohs(server.get_socket().getsockname().port()));
+        server = TCPServerSocket(sockets::TCPSocket());
+
+        bool refused = false;
+        try
+        {
+            sockets::connect_to("localhost", closed_port);
+        }
+        catch (sockets::MethodError& e)
+        {
+            refused = e.error_code == ECONNREFUSED;
+        }
+        ok = ok && refused;
+
+        cout << (ok ? "Success!" : "Fail.") << endl;
+        return ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,140 @@
+//
+// Tests that IoUring can accept, receive and send over loopback, including multishot operations and registered
+// buffers.
+//
+
+#include <sockets/IoUring.h>
+#include <sockets/TCPServerSocket.h>
+#include <sockets/abl/system.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using sockets::IoUring;
+using sockets::TCPConnection;
+using sockets::TCPServerSocket;
+using sockets::TCPSocket;
+
+using std::cout;
+using std::endl;
+
+enum Tag : uint64_t
+{
+    ACCEPT = 1,
+    PROVIDE,
+    RECV_MULTISHOT,
+    RECV_FIXED,
+    SEND_FIXED,
+    SEND
+};
+
+int main()
+{
+    static const unsigned int BUFFER_SIZE = 64;
+    static const unsigned int BUFFER_COUNT = 4;
+    static const uint16_t GROUP = 7;
+    const std::string message = "hello";
+
+    try
+    {
+        std::unique_ptr<IoUring> ring;
+        try
+        {
+            ring.reset(new IoUring(64));
+        }
+        catch (sockets::MethodError& e)
+        {
+            cout << "io_uring is unavailable, skipping: " << e.what() << endl;
+            return 0;
+        }
+
+        TCPServerSocket server("127.0.0.1", "0");
+        auto port = std::to_string(ntohs(server.get_socket().getsockname().port()));
+
+        std::vector<ByteBuffer> fixed{ByteBuffer(BUFFER_SIZE)};
+        ring->register_buffers(fixed);
+
+        ByteBuffer pool(BUFFER_SIZE * BUFFER_COUNT);
+        ring->provide_buffers(GROUP, pool.data(), BUFFER_SIZE, BUFFER_COUNT, 0, PROVIDE);
+        ring->accept(server.get_socket(), ACCEPT, true);
+        ring->submit();
+
+        TCPConnection first = sockets::connect_to("127.0.0.1", port);
+        TCPConnection second = sockets::connect_to("127.0.0.1", port);
+
+        std::vector<TCPSocket> accepted;
+        while (accepted.size() < 2)
+        {
+            ring->wait(1, [&](const IoUring::Completion& c)
+            {
+                if (c.user_data == ACCEPT)
+                {
+                    accepted.push_back(c.accepted_socket());
+                    if (!c.more()) throw std::runtime_error("multishot accept terminated early");
+                }
+                else if (c.failed())
+                {
+                    throw sockets::MethodError("io_uring_test", "provide_buffers", c.error());
+                }
+            });
+        }
+        cout << "Accepted 2 connections with one multishot accept." << endl;
+
+        ring->recv_multishot(accepted[0], GROUP, RECV_MULTISHOT);
+        ring->recv_fixed(accepted[1], 0, BUFFER_SIZE, 0, RECV_FIXED);
+
+        first.write(message.begin(), message.end());
+        second.write(message.begin(), message.end());
+
+        ByteBuffer echo;
+        bool sent = false;
+        bool sent_fixed = false;
+        while (!sent || !sent_fixed)
+        {
+            ring->wait(1, [&](const IoUring::Completion& c)
+            {
+                if (c.failed())
+                    throw sockets::MethodError("io_uring_test", "completion", c.error());
+
+                if (c.user_data == RECV_MULTISHOT)
+                {
+                    if (!c.has_buffer()) throw std::runtime_error("multishot recv did not select a buffer");
+                    auto begin = pool.begin() + c.buffer_id() * BUFFER_SIZE;
+                    echo.assign(begin, begin + c.result);
+                    ring->send(accepted[0], echo, echo.size(), 0, SEND);
+                    ring->provide_buffers(GROUP, &*begin, BUFFER_SIZE, 1, c.buffer_id(), PROVIDE);
+                }
+                else if (c.user_data == RECV_FIXED)
+                {
+                    ring->send_fixed(accepted[1], 0, static_cast<size_t>(c.result), 0, SEND_FIXED);
+                }
+                else if (c.user_data == SEND)
+                {
+                    sent = true;
+                }
+                else if (c.user_data == SEND_FIXED)
+                {
+                    sent_fixed = true;
+                }
+            });
+        }
+
+        for (auto* conn : {&first, &second})
+        {
+            auto& response = conn->read_exactly(message.size());
+            if (!std::equal(response.begin(), response.end(), message.begin(), message.end()))
+            {
+                cout << "Fail." << endl;
+                return 1;
+            }
+        }
+
+        cout << "Success!" << endl;
+        return 0;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
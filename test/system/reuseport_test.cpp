@@ -0,0 +1,65 @@
+//
+// Tests that a group of SO_REUSEPORT listeners shares one port and that every connection is accepted by exactly
+// one of them.
+//
+
+#include <sockets/EventLoop.h>
+#include <sockets/TCPServerSocket.h>
+#include <sockets/abl/system.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using sockets::EventLoop;
+using sockets::TCPConnection;
+using sockets::TCPServerSocket;
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    static const size_t LISTENER_COUNT = 4;
+    static const size_t CLIENT_COUNT = 64;
+
+    try
+    {
+        auto group = TCPServerSocket::open_group("127.0.0.1", "0", LISTENER_COUNT);
+        auto port = std::to_string(ntohs(group[0].get_socket().getsockname().port()));
+
+        bool same_port = true;
+        for (auto& server : group)
+            same_port = same_port && server.get_socket().getsockname().port() == group[0].get_socket().getsockname().port();
+
+        std::vector<TCPConnection> clients;
+        for (size_t i = 0; i < CLIENT_COUNT; ++i)
+            clients.push_back(sockets::connect_to("127.0.0.1", port));
+
+        EventLoop loop;
+        std::vector<size_t> accepted(LISTENER_COUNT);
+        std::vector<TCPConnection> peers;
+        for (size_t i = 0; i < LISTENER_COUNT; ++i)
+        {
+            loop.add(group[i], [&, i](unsigned int)
+            {
+                peers.push_back(group[i].accept());
+                ++accepted[i];
+            });
+        }
+
+        while (peers.size() < CLIENT_COUNT && loop.poll(1000) > 0);
+
+        cout << "Accepted per listener:";
+        for (auto count : accepted) cout << " " << count;
+        cout << endl;
+
+        bool ok = same_port && peers.size() == CLIENT_COUNT;
+        cout << (ok ? "Success!" : "Fail.") << endl;
+        return ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
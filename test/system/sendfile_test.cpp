@@ -0,0 +1,81 @@
+//
+// Tests that files and socket-to-socket relays are transferred correctly over loopback without user-space copies.
+//
+
+#include <sockets/TCPServerSocket.h>
+#include <sockets/abl/system.h>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+using sockets::TCPConnection;
+using sockets::TCPServerSocket;
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    static const size_t FILE_SIZE = 256 * 1024;
+
+    char path[] = "/tmp/sendfile_testXXXXXX";
+    int file = mkstemp(path);
+    if (file == -1)
+    {
+        std::cerr << "Error: could not create a temporary file." << endl;
+        return 1;
+    }
+
+    ByteBuffer contents(FILE_SIZE);
+    for (size_t i = 0; i < contents.size(); ++i)
+        contents[i] = static_cast<byte>(i * 7);
+    bool written = write(file, contents.data(), contents.size()) == static_cast<ssize_t>(contents.size());
+    close(file);
+
+    int rv = 1;
+    try
+    {
+        if (!written) throw std::runtime_error("could not write the temporary file");
+
+        TCPServerSocket server("127.0.0.1", "0");
+        auto port = std::to_string(ntohs(server.get_socket().getsockname().port()));
+
+        // sendfile: the whole file, then a range of it
+        TCPConnection client = sockets::connect_to("127.0.0.1", port);
+        TCPConnection peer = server.accept();
+
+        size_t sent = peer.get_socket().sendfile(path);
+        sent += peer.get_socket().sendfile(path, 16, 32);
+        auto& received = client.read_exactly(FILE_SIZE + 32);
+
+        bool file_ok = sent == FILE_SIZE + 32 &&
+                       std::equal(contents.begin(), contents.end(), received.begin()) &&
+                       std::equal(contents.begin() + 16, contents.begin() + 48, received.begin() + FILE_SIZE);
+        cout << "sendfile: " << (file_ok ? "ok" : "failed") << endl;
+
+        // relay: source -> proxy_in -> proxy_out -> sink
+        std::unique_ptr<TCPConnection> source(new TCPConnection(sockets::connect_to("127.0.0.1", port)));
+        TCPConnection proxy_in = server.accept();
+        TCPConnection sink = sockets::connect_to("127.0.0.1", port);
+        TCPConnection proxy_out = server.accept();
+
+        source->write_all(contents);
+        source.reset();
+
+        size_t relayed = sockets::relay(proxy_in.get_socket(), proxy_out.get_socket());
+        auto& forwarded = sink.read_exactly(FILE_SIZE);
+
+        bool relay_ok = relayed == FILE_SIZE && forwarded == contents;
+        cout << "relay: " << (relay_ok ? "ok" : "failed") << endl;
+
+        rv = file_ok && relay_ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+    }
+
+    unlink(path);
+    return rv;
+}
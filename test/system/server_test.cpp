@@ -31,7 +31,7 @@ int main(int argc, char** argv)
     {
         try {
             // Check connection state
-            conn.write<1>(ByteString<1>{{1}});
+            conn.write_all(ByteString<1>{{1}});
 
             auto b = conn.read(128);
             cout << "[" << ip.name() << ":" << ip.port() << "] " << b << endl;
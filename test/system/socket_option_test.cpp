@@ -0,0 +1,79 @@
+//
+// Tests setting and reading typed socket options on a loopback connection, and applying options to accepted
+// connections with TCPServerSocket::set_accepted_option().
+//
+
+#include <sockets/Connection.h>
+#include <sockets/TCPServerSocket.h>
+#include <sockets/TCPSocket.h>
+#include <sockets/abl/system.h>
+#include <iostream>
+#include <string>
+
+using sockets::TCPServerSocket;
+using sockets::TCPSocket;
+using sockets::abl::IpAddress;
+
+namespace options = sockets::options;
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    try
+    {
+        TCPServerSocket server(IpAddress(sockets::abl::INET, "127.0.0.1", 0), sockets::ListenOptions());
+        server.set_accepted_option(options::NoDelay{true});
+        server.set_accepted_option(options::KeepAlive{true});
+#ifdef __linux__
+        server.set_accepted_option(options::UserTimeout{std::chrono::milliseconds(7000)});
+#endif
+        auto port = std::to_string(ntohs(server.get_socket().getsockname().port()));
+
+        auto client = sockets::connect_to("127.0.0.1", port);
+        auto accepted = server.accept();
+
+        bool ok = accepted.get_socket().get_option<options::NoDelay>().value &&
+                  accepted.get_socket().get_option<options::KeepAlive>().value;
+
+        // Inherited options are set on the listener itself, other options only on accepted sockets
+        ok = ok && server.get_socket().get_option<options::NoDelay>().value;
+#ifdef __linux__
+        ok = ok && accepted.get_socket().get_option<options::UserTimeout>().value == std::chrono::milliseconds(7000);
+        ok = ok && server.get_socket().get_option<options::UserTimeout>().value == std::chrono::milliseconds(0);
+#endif
+
+        TCPSocket& socket = client.get_socket();
+        ok = ok && !socket.get_option<options::NoDelay>().value;
+        socket.set_option(options::NoDelay{true});
+        ok = ok && socket.get_option<options::NoDelay>().value;
+
+        socket.set_option(options::ReceiveBuffer{64 * 1024});
+        ok = ok && socket.get_option<options::ReceiveBuffer>().value >= 64 * 1024;
+
+        socket.set_option(options::Linger{true, std::chrono::seconds(3)});
+        auto linger = socket.get_option<options::Linger>();
+        ok = ok && linger.enabled && linger.timeout == std::chrono::seconds(3);
+
+        TCPSocket unbound(sockets::abl::INET);
+        unbound.set_reuse_address(true);
+        ok = ok && unbound.get_option<options::ReuseAddress>().value;
+
+#ifdef __linux__
+        socket.set_option(options::KeepIdle{std::chrono::seconds(30)});
+        ok = ok && socket.get_option<options::KeepIdle>().value == std::chrono::seconds(30);
+
+        socket.set_option(options::UserTimeout{std::chrono::milliseconds(5000)});
+        ok = ok && socket.get_option<options::UserTimeout>().value == std::chrono::milliseconds(5000);
+#endif
+
+        cout << (ok ? "Success!" : "Fail.") << endl;
+        return ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,71 @@
+//
+// Tests that a segmented UDP send arrives as the expected datagrams over loopback, whether or not the receiver
+// gets them coalesced.
+//
+
+#include <sockets/UDPSocket.h>
+#include <sockets/Error.h>
+#include <iostream>
+#include <tuple>
+
+using sockets::UDPSocket;
+using sockets::abl::IpAddress;
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    static const uint16_t SEGMENT_SIZE = 1000;
+    static const size_t SEGMENT_COUNT = 10;
+    static const size_t TOTAL_SIZE = SEGMENT_SIZE * SEGMENT_COUNT;
+
+    try
+    {
+        UDPSocket receiver(sockets::abl::INET);
+        receiver.bind(IpAddress(sockets::abl::INET, "127.0.0.1", 0));
+        receiver.enable_gro();
+
+        UDPSocket sender(sockets::abl::INET);
+
+        // Every segment is filled with its index
+        ByteBuffer payload(TOTAL_SIZE);
+        for (size_t i = 0; i < TOTAL_SIZE; ++i)
+            payload[i] = static_cast<byte>(i / SEGMENT_SIZE);
+
+        try
+        {
+            sender.send_segmented(payload.data(), payload.size(), SEGMENT_SIZE, receiver.getsockname());
+        }
+        catch (sockets::SocketWriteError& e)
+        {
+            cout << "UDP_SEGMENT is unavailable, skipping: " << e.what() << endl;
+            return 0;
+        }
+
+        ByteBuffer buffer;
+        size_t total = 0;
+        size_t calls = 0;
+        bool ok = true;
+        while (ok && total < TOTAL_SIZE)
+        {
+            size_t received, segment_size;
+            IpAddress from;
+            std::tie(received, segment_size, from) = receiver.recv_coalesced(buffer, 65536);
+            ++calls;
+
+            ok = segment_size == SEGMENT_SIZE && received % SEGMENT_SIZE == 0 &&
+                 std::equal(buffer.begin(), buffer.end(), payload.begin() + total);
+            total += received;
+        }
+
+        cout << "Received " << total << " bytes in " << calls << " calls." << endl;
+        cout << (ok ? "Success!" : "Fail.") << endl;
+        return ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
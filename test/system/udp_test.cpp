@@ -0,0 +1,89 @@
+//
+// Tests that UDPSocket can exchange single and batched datagrams over loopback.
+//
+
+#include <sockets/UDPSocket.h>
+#include <sockets/abl/system.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using sockets::Datagram;
+using sockets::OutgoingDatagram;
+using sockets::UDPSocket;
+using sockets::abl::IpAddress;
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    static const size_t BATCH_SIZE = 100;
+    static const size_t DATAGRAM_SIZE = 32;
+
+    try
+    {
+        UDPSocket receiver(sockets::abl::INET);
+        receiver.bind(IpAddress(sockets::abl::INET, "127.0.0.1", 0));
+        IpAddress address = receiver.getsockname();
+
+        UDPSocket sender(sockets::abl::INET);
+        sender.bind(IpAddress(sockets::abl::INET, "127.0.0.1", 0));
+        IpAddress sender_address = sender.getsockname();
+
+        // sendto/recvfrom
+        const std::string message = "hello";
+        sender.sendto(reinterpret_cast<const byte*>(message.data()), message.size(), address);
+
+        ByteBuffer buffer;
+        size_t received;
+        IpAddress from;
+        std::tie(received, from) = receiver.recvfrom(buffer, 64);
+
+        bool single_ok = received == message.size() &&
+                         std::equal(buffer.begin(), buffer.end(), message.begin(), message.end()) &&
+                         from.port() == sender_address.port();
+        cout << "sendto/recvfrom: " << (single_ok ? "ok" : "failed") << endl;
+
+        // send_many/recv_many
+        std::vector<ByteBuffer> payloads;
+        std::vector<OutgoingDatagram> outgoing;
+        for (size_t i = 0; i < BATCH_SIZE; ++i)
+            payloads.emplace_back(DATAGRAM_SIZE, static_cast<byte>(i));
+        for (auto& payload : payloads)
+            outgoing.push_back(OutgoingDatagram{payload, address});
+
+        size_t sent = sender.send_many(outgoing.data(), outgoing.size());
+
+        ByteBuffer slab(BATCH_SIZE * DATAGRAM_SIZE);
+        std::vector<Datagram> incoming(BATCH_SIZE);
+
+        size_t total = 0;
+        bool batch_ok = sent == BATCH_SIZE;
+        while (batch_ok && total < BATCH_SIZE)
+        {
+            for (size_t i = total; i < BATCH_SIZE; ++i)
+                incoming[i].data = ByteView{slab.data() + i * DATAGRAM_SIZE, DATAGRAM_SIZE};
+
+            size_t count = receiver.recv_many(incoming.data() + total, BATCH_SIZE - total);
+            for (size_t i = total; i < total + count; ++i)
+            {
+                const Datagram& datagram = incoming[i];
+                batch_ok = batch_ok && datagram.data.size == DATAGRAM_SIZE &&
+                           datagram.data.data[0] == static_cast<byte>(i) &&
+                           datagram.address.port() == sender_address.port();
+            }
+            total += count;
+        }
+        cout << "send_many/recv_many: " << (batch_ok ? "ok" : "failed") << endl;
+
+        bool ok = single_ok && batch_ok;
+        cout << (ok ? "Success!" : "Fail.") << endl;
+        return ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,91 @@
+//
+// Tests that local datagram sockets keep message boundaries, report the address of the sender, and that paired
+// sockets are close-on-exec.
+//
+
+#include <sockets/UnixDatagramSocket.h>
+#include <sockets/abl/system.h>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+using sockets::UnixDatagramSocket;
+using sockets::abl::LocalAddress;
+
+using std::cout;
+using std::endl;
+
+namespace
+{
+    bool close_on_exec(const UnixDatagramSocket& socket)
+    {
+        return (fcntl(sockets::abl::system::get_system_handle(socket.handle), F_GETFD) & FD_CLOEXEC) != 0;
+    }
+
+    bool received(const UnixDatagramSocket& socket, const std::string& expected, LocalAddress* from = nullptr)
+    {
+        ByteBuffer buffer;
+        auto result = socket.recvfrom(buffer, 1024);
+        if(from != nullptr)
+            *from = std::get<1>(result);
+
+        return std::get<0>(result) == expected.size() &&
+               std::equal(buffer.begin(), buffer.end(), expected.begin(), expected.end());
+    }
+
+    const byte* data(const std::string& s)
+    {
+        return reinterpret_cast<const byte*>(s.data());
+    }
+}
+
+int main()
+{
+    std::string server_path = "/tmp/unix_datagram_test.server." + std::to_string(getpid());
+    std::string client_path = "/tmp/unix_datagram_test.client." + std::to_string(getpid());
+    int rv = 1;
+
+    try
+    {
+        auto server = UnixDatagramSocket::open();
+        server.bind(LocalAddress(server_path));
+
+        auto client = UnixDatagramSocket::open();
+        client.bind(LocalAddress(client_path));
+
+        // Two datagrams sent back to back are received separately
+        const std::string first = "ping", second = "a longer second datagram";
+        client.sendto(data(first), first.size(), LocalAddress(server_path));
+        client.sendto(data(second), second.size(), LocalAddress(server_path));
+
+        LocalAddress from;
+        bool boundaries_ok = received(server, first, &from) && received(server, second);
+        cout << "message boundaries: " << (boundaries_ok ? "ok" : "failed") << endl;
+
+        bool sender_ok = from.path() == client_path && server.getsockname().path() == server_path;
+        cout << "sender address: " << (sender_ok ? "ok" : "failed") << endl;
+
+        // A reply to the reported address reaches the bound client
+        server.sendto(data(first), first.size(), from);
+        bool reply_ok = received(client, first);
+        cout << "reply: " << (reply_ok ? "ok" : "failed") << endl;
+
+        auto pair = UnixDatagramSocket::pair();
+        std::get<0>(pair).send(data(second), second.size());
+        bool pair_ok = received(std::get<1>(pair), second) &&
+                       close_on_exec(std::get<0>(pair)) && close_on_exec(std::get<1>(pair));
+        cout << "pair: " << (pair_ok ? "ok" : "failed") << endl;
+
+        rv = boundaries_ok && sender_ok && reply_ok && pair_ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+    }
+
+    unlink(server_path.c_str());
+    unlink(client_path.c_str());
+    cout << (rv == 0 ? "Success!" : "Fail.") << endl;
+    return rv;
+}
@@ -0,0 +1,80 @@
+//
+// Tests that local stream and seqpacket sockets can exchange data through Connections, including sockets in the
+// Linux abstract namespace. Accepted and paired sockets must be close-on-exec.
+//
+
+#include <sockets/UnixServerSocket.h>
+#include <sockets/abl/system.h>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+using sockets::UnixConnection;
+using sockets::UnixServerSocket;
+using sockets::UnixStreamSocket;
+using sockets::abl::LocalAddress;
+
+using std::cout;
+using std::endl;
+
+namespace
+{
+    bool close_on_exec(const UnixStreamSocket& socket)
+    {
+        return (fcntl(sockets::abl::system::get_system_handle(socket.handle), F_GETFD) & FD_CLOEXEC) != 0;
+    }
+
+    bool echo(const LocalAddress& address, sockets::abl::sock_type type)
+    {
+        const std::string message = "ping";
+
+        UnixServerSocket server(address, 16, type);
+        UnixConnection client = sockets::connect_local(address, type);
+        UnixConnection peer = server.accept();
+
+        client.write_all(message);
+        auto& request = peer.read_exactly(message.size());
+        peer.write_all(request);
+        auto& response = client.read_exactly(message.size());
+
+        return std::equal(response.begin(), response.end(), message.begin(), message.end()) &&
+               peer.get_socket().getsockname().path() == address.path() && close_on_exec(peer.get_socket());
+    }
+}
+
+int main()
+{
+    std::string path = "/tmp/unix_socket_test." + std::to_string(getpid());
+    int rv = 1;
+
+    try
+    {
+        bool stream_ok = echo(LocalAddress(path), sockets::abl::sock_type::STREAM);
+        cout << "stream: " << (stream_ok ? "ok" : "failed") << endl;
+
+        // Binding again replaces the stale socket left behind by the first server.
+        bool seqpacket_ok = echo(LocalAddress(path), sockets::abl::sock_type::SEQPACKET);
+        cout << "seqpacket: " << (seqpacket_ok ? "ok" : "failed") << endl;
+
+        bool abstract_ok = true;
+#ifdef __linux__
+        abstract_ok = echo(LocalAddress::abstract(path), sockets::abl::sock_type::STREAM);
+        cout << "abstract: " << (abstract_ok ? "ok" : "failed") << endl;
+#endif
+
+        auto pair = UnixStreamSocket::pair();
+        bool pair_ok = close_on_exec(std::get<0>(pair)) && close_on_exec(std::get<1>(pair));
+        cout << "pair close-on-exec: " << (pair_ok ? "ok" : "failed") << endl;
+
+        rv = stream_ok && seqpacket_ok && abstract_ok && pair_ok ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+    }
+
+    unlink(path.c_str());
+    cout << (rv == 0 ? "Success!" : "Fail.") << endl;
+    return rv;
+}
@@ -7,6 +7,8 @@
 #include <abl/system.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <list>
 #include <sockets/Connection.h>
 
 using sockets::abl::UniqueHandle;
@@ -286,7 +288,21 @@ TEST_CASE("Connection::read_until() reads until a delimiter is encountered", "[C
         REQUIRE(std::equal(actual.begin(), actual.end(), expected.begin(), expected.end()));
     }
 
-    SECTION("read_until() deletes excess bytes")
+    SECTION("multi-byte delimiter split across two calls to recv")
+    {
+        // The stream is "\na\r" "\na\r\n". The first delimiter starts in the first chunk and ends in the second.
+        OutputSocketStub<2, 3, 1> stub({'\n', 'a', '\r'}, {'\n'});
+        Connection<OutputSocketStub<2, 3, 1>> conn(std::move(stub));
+
+        ByteBuffer expected{'\n', 'a', '\r', '\n'};
+        ByteBuffer actual;
+
+        REQUIRE_NOTHROW(actual = conn.read_until<2>({'\r', '\n'}));
+        REQUIRE(expected == actual);
+        REQUIRE(conn.buffered() == 3);
+    }
+
+    SECTION("read_until() does not return excess bytes")
     {
         OutputSocketStub<1, 3, 8> stub({'a', 'b', 'c'}, {'d', 'e', '\r', '\n', 5, 6, 7});
         Connection<OutputSocketStub<1, 3, 8>> conn(std::move(stub));
@@ -297,4 +313,367 @@ TEST_CASE("Connection::read_until() reads until a delimiter is encountered", "[C
         REQUIRE_NOTHROW(actual = conn.read_until<2>({'\r', '\n'}));
         REQUIRE(expected == actual);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Connection keeps bytes received after a delimiter for the following reads", "[Connection]")
+{
+    using sockets::Connection;
+
+    // The whole stream arrives in a single call to recv. Any further call to recv throws.
+    using Stub = OutputSocketStub<1, 4, 11>;
+    static const ByteString<2> DELIMITER{'\r', '\n'};
+
+    Connection<Stub> conn(Stub({'a', 'b', '\r', '\n'}, {'c', '\r', '\n', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k'}));
+
+    REQUIRE(conn.read_until(DELIMITER) == ByteBuffer{'a', 'b', '\r', '\n'});
+    REQUIRE(conn.buffered() == 11);
+
+    SECTION("read_until() returns pipelined messages from the buffered bytes")
+    {
+        REQUIRE(conn.read_until(DELIMITER) == ByteBuffer{'c', '\r', '\n'});
+        REQUIRE(conn.buffered() == 8);
+    }
+
+    SECTION("read_exactly() and read() return the buffered bytes")
+    {
+        REQUIRE(conn.read_until(DELIMITER) == ByteBuffer{'c', '\r', '\n'});
+        REQUIRE(conn.read_exactly(3) == ByteBuffer{'d', 'e', 'f'});
+        REQUIRE(conn.read(64) == ByteBuffer{'g', 'h', 'i', 'j', 'k'});
+        REQUIRE(conn.buffered() == 0);
+    }
+
+    SECTION("reads continue from the network once the buffered bytes are used up")
+    {
+        REQUIRE_THROWS_AS(conn.read_exactly(12), sockets::SocketReadError);
+    }
+}
+
+TEST_CASE("Connection::read_until() enforces a maximum message size", "[Connection]")
+{
+    using sockets::Connection;
+
+    // The stream is 21 bytes followed by the delimiter, in chunks of 7 bytes
+    using Stub = OutputSocketStub<3, 7, 1>;
+    static const ByteString<1> DELIMITER{'\n'};
+
+    SECTION("a message longer than the limit throws MessageTooLargeError")
+    {
+        Connection<Stub> conn(Stub({'a', 'b', 'c', 'd', 'e', 'f', 'g'}, DELIMITER));
+
+        REQUIRE_THROWS_AS(conn.read_until(DELIMITER, size_t(10)), sockets::MessageTooLargeError);
+    }
+
+    SECTION("the bytes of a message that is too large stay buffered")
+    {
+        Connection<Stub> conn(Stub({'a', 'b', 'c', 'd', 'e', 'f', 'g'}, DELIMITER));
+
+        REQUIRE_THROWS_AS(conn.read_until(DELIMITER, size_t(10)), sockets::MessageTooLargeError);
+        REQUIRE(conn.buffered() >= 10);
+        REQUIRE(conn.read_exactly(10) == ByteBuffer{'a', 'b', 'c', 'd', 'e', 'f', 'g', 'a', 'b', 'c'});
+    }
+
+    SECTION("a message exactly as long as the limit is returned")
+    {
+        Connection<Stub> conn(Stub({'a', 'b', 'c', 'd', 'e', 'f', 'g'}, DELIMITER));
+
+        REQUIRE(conn.read_until(DELIMITER, size_t(22)).size() == 22);
+    }
+
+    SECTION("the connection-level limit applies to buffered messages")
+    {
+        Connection<OutputSocketStub<1, 4, 6>> conn(OutputSocketStub<1, 4, 6>({'a', '\n', 'b', 'c'},
+                                                                           {'d', 'e', 'f', '\n', 'g', '\n'}));
+        conn.set_max_message_size(3);
+
+        REQUIRE(conn.read_until(DELIMITER) == ByteBuffer{'a', '\n'});
+        REQUIRE_THROWS_AS(conn.read_until(DELIMITER), sockets::MessageTooLargeError);
+        REQUIRE(conn.buffered() == 8);
+    }
+}
+
+TEST_CASE("Connection reports a connection closed by the peer", "[Connection]")
+{
+    using sockets::Connection;
+
+    Connection<ReceiveSocketStub> conn(ReceiveSocketStub{0});
+
+    REQUIRE_THROWS_AS(conn.read_exactly(4), sockets::ClosedError);
+    REQUIRE(conn.closed());
+}
+
+/**
+ * Records the memory passed to each call to send(). Every send is reported as complete.
+ */
+struct SendSocketStub
+{
+    const byte* last_data = nullptr;
+    ByteBuffer sent;
+
+    SendSocketStub() = default;
+    SendSocketStub(SendSocketStub&&) noexcept = default;
+    SendSocketStub& operator=(SendSocketStub&&) noexcept = default;
+
+    ssize_t
+    recv(ByteBuffer&, size_t, size_t = 0, int = 0) { return 0; }
+
+    ssize_t
+    send(const ByteBuffer& b, size_t amount, int) { return send(b.data(), amount, 0); }
+
+    ssize_t
+    send(const ByteBuffer& b, size_t amount, size_t offset, int) { return send(b.data() + offset, amount, 0); }
+
+    ssize_t
+    send(const byte* data, size_t amount, int)
+    {
+        last_data = data;
+        sent.insert(sent.end(), data, data + amount);
+        return amount;
+    }
+
+    bool
+    invalid()
+    {
+        return false;
+    }
+};
+
+TEST_CASE("Connection::write() sends contiguous memory without copying", "[Connection]")
+{
+    using sockets::Connection;
+
+    Connection<SendSocketStub> conn{SendSocketStub()};
+    auto& socket = conn.get_socket();
+
+    SECTION("ByteBuffer")
+    {
+        ByteBuffer data{1, 2, 3};
+
+        REQUIRE(conn.write(data) == 3);
+        REQUIRE(socket.last_data == data.data());
+        REQUIRE(socket.sent == data);
+    }
+
+    SECTION("std::string")
+    {
+        std::string data = "abc";
+
+        REQUIRE(conn.write(data) == 3);
+        REQUIRE(socket.last_data == reinterpret_cast<const byte*>(data.data()));
+    }
+
+    SECTION("contiguous iterators")
+    {
+        std::string data = "abc";
+
+        REQUIRE(conn.write(data.begin(), data.end()) == 3);
+        REQUIRE(socket.last_data == reinterpret_cast<const byte*>(data.data()));
+    }
+
+    SECTION("non-contiguous iterators are copied")
+    {
+        std::list<byte> data{1, 2, 3};
+
+        REQUIRE(conn.write(data.begin(), data.end()) == 3);
+        REQUIRE(socket.sent == ByteBuffer{1, 2, 3});
+    }
+}
+
+/**
+ * Accepts at most `limit` bytes per call to sendv(), to simulate a socket whose send buffer is full.
+ */
+struct VectorSendSocketStub : public SendSocketStub
+{
+    size_t limit;
+    size_t calls = 0;
+
+    explicit VectorSendSocketStub(size_t limit) : limit(limit) {}
+
+    size_t
+    sendv(const ConstByteView* views, size_t count, int)
+    {
+        ++calls;
+        size_t sent = 0;
+        for (size_t i = 0; i < count && sent < limit; ++i)
+        {
+            size_t n = std::min(views[i].size, limit - sent);
+            send(views[i].data, n, 0);
+            sent += n;
+        }
+        return sent;
+    }
+};
+
+TEST_CASE("Connection::write_all() writes several buffers", "[Connection]")
+{
+    using sockets::Connection;
+
+    ByteBuffer header{'h', 'h'};
+    std::string body = "body";
+    ByteString<3> trailer{{'t', 't', 't'}};
+    ByteBuffer expected{'h', 'h', 'b', 'o', 'd', 'y', 't', 't', 't'};
+
+    SECTION("with a single call to sendv when the socket accepts every byte")
+    {
+        Connection<VectorSendSocketStub> conn{VectorSendSocketStub(64)};
+
+        REQUIRE(conn.write_all(header, body, trailer) == expected.size());
+        REQUIRE(conn.get_socket().sent == expected);
+        REQUIRE(conn.get_socket().calls == 1);
+    }
+
+    SECTION("completely when the socket accepts partial writes")
+    {
+        Connection<VectorSendSocketStub> conn{VectorSendSocketStub(3)};
+
+        REQUIRE(conn.write_all(header, body, trailer) == expected.size());
+        REQUIRE(conn.get_socket().sent == expected);
+    }
+}
+
+/**
+ * Accepts up to `capacity` more bytes through try_send(), then reports that the write would block.
+ */
+struct NonBlockingSendSocketStub : public SendSocketStub
+{
+    size_t capacity;
+
+    explicit NonBlockingSendSocketStub(size_t capacity) : capacity(capacity) {}
+
+    sockets::IoResult
+    try_send(const byte* data, size_t amount, int)
+    {
+        if (capacity == 0) return sockets::IoResult{sockets::IoResult::WOULD_BLOCK, 0};
+
+        size_t n = std::min(amount, capacity);
+        capacity -= n;
+        send(data, n, 0);
+        return sockets::IoResult{sockets::IoResult::OK, n};
+    }
+};
+
+TEST_CASE("Connection::write_nonblocking() queues bytes that cannot be sent", "[Connection]")
+{
+    using sockets::Connection;
+
+    Connection<NonBlockingSendSocketStub> conn{NonBlockingSendSocketStub(4)};
+    auto& socket = conn.get_socket();
+
+    REQUIRE(conn.write_nonblocking(std::string("abcdef")) == 4);
+    REQUIRE(conn.pending() == 2);
+
+    SECTION("flush() keeps the queue while the socket is not writable")
+    {
+        REQUIRE_FALSE(conn.flush());
+        REQUIRE(conn.pending() == 2);
+    }
+
+    SECTION("later writes are queued behind pending bytes, and flush() sends them in order")
+    {
+        socket.capacity = 64;
+
+        REQUIRE(conn.write_nonblocking(std::string("gh")) == 0);
+        REQUIRE(conn.pending() == 4);
+
+        REQUIRE(conn.flush());
+        REQUIRE(conn.pending() == 0);
+        REQUIRE(socket.sent == ByteBuffer{'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'});
+    }
+}
+
+TEST_CASE("Connection::write_all() retries partial writes of a single buffer", "[Connection]")
+{
+    using sockets::Connection;
+
+    struct PartialSendSocketStub : public SendSocketStub
+    {
+        using SendSocketStub::send;
+
+        ssize_t
+        send(const byte* data, size_t amount, int)
+        {
+            return SendSocketStub::send(data, std::min<size_t>(amount, 2), 0);
+        }
+    };
+
+    Connection<PartialSendSocketStub> conn{PartialSendSocketStub()};
+
+    REQUIRE(conn.write_all(std::string("abcde")) == 5);
+    REQUIRE(conn.get_socket().sent == ByteBuffer{'a', 'b', 'c', 'd', 'e'});
+}
+
+TEST_CASE("Connection::queue() coalesces small writes", "[Connection]")
+{
+    using sockets::Connection;
+
+    struct CountingSocketStub : public NonBlockingSendSocketStub
+    {
+        size_t sends = 0;
+        bool fail_sends = false;
+        std::vector<bool> cork_changes;
+
+        CountingSocketStub() : NonBlockingSendSocketStub(1024) {}
+
+        sockets::IoResult
+        try_send(const byte* data, size_t amount, int flags)
+        {
+            ++sends;
+            if (fail_sends) throw sockets::SocketWriteError("CountingSocketStub::try_send", EIO);
+            return NonBlockingSendSocketStub::try_send(data, amount, flags);
+        }
+
+        void
+        set_cork(bool cork)
+        {
+            cork_changes.push_back(cork);
+        }
+    };
+
+    Connection<CountingSocketStub> conn{CountingSocketStub()};
+    auto& socket = conn.get_socket();
+
+    SECTION("queued bytes are sent together by flush()")
+    {
+        conn.queue(std::string("ab"));
+        conn.queue(ByteBuffer{'c'});
+        conn.queue(ByteString<2>{{'d', 'e'}});
+        REQUIRE(socket.sends == 0);
+        REQUIRE(conn.pending() == 5);
+
+        REQUIRE(conn.flush());
+        REQUIRE(socket.sends == 1);
+        REQUIRE(socket.sent == ByteBuffer{'a', 'b', 'c', 'd', 'e'});
+        REQUIRE(socket.cork_changes.empty());
+    }
+
+    SECTION("the queue is flushed automatically once the threshold is reached")
+    {
+        conn.set_flush_threshold(4);
+
+        conn.queue(std::string("abc"));
+        REQUIRE(socket.sends == 0);
+
+        conn.queue(std::string("de"));
+        REQUIRE(socket.sends == 1);
+        REQUIRE(conn.pending() == 0);
+    }
+
+    SECTION("flush() corks the socket while sending when enabled")
+    {
+        conn.set_cork_on_flush(true);
+
+        conn.queue(std::string("abc"));
+        REQUIRE(conn.flush());
+        REQUIRE(socket.cork_changes == std::vector<bool>{true, false});
+    }
+
+    SECTION("flush() uncorks the socket when a send throws")
+    {
+        conn.set_cork_on_flush(true);
+        socket.fail_sends = true;
+
+        conn.queue(std::string("abc"));
+        REQUIRE_THROWS_AS(conn.flush(), sockets::SocketWriteError);
+        REQUIRE(socket.cork_changes == std::vector<bool>{true, false});
+        REQUIRE(conn.pending() == 3);
+    }
+}
@@ -0,0 +1,171 @@
+//
+// Tests that TimerWheel runs timers at their expiry across every level of the wheel, and that cancelled and
+// rescheduled timers behave accordingly.
+//
+
+#include "catch.hpp"
+
+#include <sockets/TimerWheel.h>
+#include <vector>
+
+using sockets::TimerWheel;
+using std::chrono::milliseconds;
+
+TEST_CASE("TimerWheel runs timers once their delay has passed", "[TimerWheel]")
+{
+    const TimerWheel::clock::time_point start{};
+    TimerWheel wheel(milliseconds(1), start);
+
+    SECTION("a timer does not run early, and runs once")
+    {
+        int runs = 0;
+        wheel.schedule(milliseconds(10), [&]() { ++runs; }, start);
+
+        REQUIRE(wheel.advance(start + milliseconds(9)) == 0);
+        REQUIRE(runs == 0);
+        REQUIRE(wheel.advance(start + milliseconds(10)) == 1);
+        REQUIRE(wheel.advance(start + milliseconds(100)) == 0);
+        REQUIRE(runs == 1);
+        REQUIRE(wheel.empty());
+    }
+
+    SECTION("timers in every level run at their expiry, in order")
+    {
+        const std::vector<long> delays{3, 255, 256, 300, 65535, 65536, 70000, 16777216, 20000000};
+
+        std::vector<long> ran_at;
+        long now = 0;
+        for (auto delay : delays)
+            wheel.schedule(milliseconds(delay), [&ran_at, &now]() { ran_at.push_back(now); }, start);
+
+        // Advance in uneven steps, so some calls process many ticks at once
+        for (now = 0; now <= 20000000; now += (now < 70000 ? 1 : 997))
+            wheel.advance(start + milliseconds(now));
+        wheel.advance(start + milliseconds(now));
+
+        REQUIRE(ran_at.size() == delays.size());
+        for (size_t i = 0; i < delays.size(); ++i)
+        {
+            REQUIRE(ran_at[i] >= delays[i]);
+            REQUIRE(ran_at[i] < delays[i] + 997);
+        }
+    }
+
+    SECTION("a long jump runs every expired timer")
+    {
+        int runs = 0;
+        for (long delay = 1; delay < 100000; delay *= 3)
+            wheel.schedule(milliseconds(delay), [&]() { ++runs; }, start);
+
+        REQUIRE(wheel.advance(start + milliseconds(200000)) == 11);
+        REQUIRE(runs == 11);
+    }
+
+    SECTION("delays are measured from when a timer is scheduled, not from the last advance()")
+    {
+        int runs = 0;
+
+        // Nothing was pending, so a loop would not have called advance() for a long time
+        auto scheduled = start + milliseconds(60000);
+        wheel.schedule(milliseconds(30000), [&]() { ++runs; }, scheduled);
+
+        REQUIRE(wheel.advance(scheduled + milliseconds(1)) == 0);
+        REQUIRE(wheel.advance(scheduled + milliseconds(29999)) == 0);
+        REQUIRE(runs == 0);
+        REQUIRE(wheel.advance(scheduled + milliseconds(30000)) == 1);
+        REQUIRE(runs == 1);
+    }
+
+    SECTION("timers scheduled between ticks never run early")
+    {
+        TimerWheel coarse(milliseconds(10), start);
+        int runs = 0;
+
+        coarse.advance(start + milliseconds(100));
+        coarse.schedule(milliseconds(15), [&]() { ++runs; }, start + milliseconds(107));
+
+        REQUIRE(coarse.advance(start + milliseconds(121)) == 0);
+        REQUIRE(coarse.advance(start + milliseconds(122)) == 0);
+        REQUIRE(coarse.advance(start + milliseconds(130)) == 1);
+        REQUIRE(runs == 1);
+    }
+}
+
+TEST_CASE("TimerWheel cancels and reschedules timers", "[TimerWheel]")
+{
+    const TimerWheel::clock::time_point start{};
+    TimerWheel wheel(milliseconds(1), start);
+
+    int runs = 0;
+    auto id = wheel.schedule(milliseconds(50), [&]() { ++runs; }, start);
+
+    SECTION("a cancelled timer never runs")
+    {
+        REQUIRE(wheel.cancel(id));
+        REQUIRE_FALSE(wheel.cancel(id));
+        REQUIRE(wheel.advance(start + milliseconds(100)) == 0);
+        REQUIRE(runs == 0);
+    }
+
+    SECTION("a rescheduled timer runs at its new expiry")
+    {
+        wheel.advance(start + milliseconds(40));
+        REQUIRE(wheel.reschedule(id, milliseconds(1000), start + milliseconds(40)));
+
+        wheel.advance(start + milliseconds(1039));
+        REQUIRE(runs == 0);
+        wheel.advance(start + milliseconds(1040));
+        REQUIRE(runs == 1);
+        REQUIRE_FALSE(wheel.reschedule(id, milliseconds(10), start + milliseconds(1040)));
+    }
+
+    SECTION("an identifier does not refer to a later timer that reuses its storage")
+    {
+        REQUIRE(wheel.cancel(id));
+        auto other = wheel.schedule(milliseconds(50), [&]() { runs += 10; }, start);
+
+        REQUIRE(other != id);
+        REQUIRE_FALSE(wheel.cancel(id));
+        REQUIRE(wheel.advance(start + milliseconds(50)) == 1);
+        REQUIRE(runs == 10);
+    }
+
+    SECTION("a callback may cancel a timer due in the same tick, and schedule new ones")
+    {
+        // Whichever of the two runs first cancels the other
+        TimerWheel::timer_id first = TimerWheel::INVALID_TIMER, second = TimerWheel::INVALID_TIMER;
+        first = wheel.schedule(milliseconds(50), [&]() {
+            runs += 10;
+            wheel.cancel(second);
+            wheel.schedule(milliseconds(5), [&]() { runs += 100; }, start + milliseconds(50));
+        }, start);
+        second = wheel.schedule(milliseconds(50), [&]() {
+            runs += 10;
+            wheel.cancel(first);
+            wheel.schedule(milliseconds(5), [&]() { runs += 100; }, start + milliseconds(50));
+        }, start);
+
+        REQUIRE(wheel.advance(start + milliseconds(50)) == 2);
+        REQUIRE(runs == 11);
+        REQUIRE(wheel.advance(start + milliseconds(55)) == 1);
+        REQUIRE(runs == 111);
+        REQUIRE(wheel.empty());
+    }
+}
+
+TEST_CASE("TimerWheel::next_timeout_ms() never waits past the next timer", "[TimerWheel]")
+{
+    const TimerWheel::clock::time_point start{};
+    TimerWheel wheel(milliseconds(1), start);
+
+    REQUIRE(wheel.next_timeout_ms(start) == -1);
+
+    wheel.schedule(milliseconds(20), []() {}, start);
+    int timeout = wheel.next_timeout_ms(start);
+    REQUIRE(timeout >= 0);
+    REQUIRE(timeout <= 21);
+
+    wheel.schedule(milliseconds(5), []() {}, start);
+    REQUIRE(wheel.next_timeout_ms(start) <= 6);
+    REQUIRE(wheel.next_timeout_ms(start + milliseconds(30)) == 0);
+}